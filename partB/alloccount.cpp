@@ -0,0 +1,104 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <cstdlib>
+#include <new>
+#include "alloccount.h"
+using namespace std;
+
+#ifdef TRACK_ALLOCATIONS
+
+thread_local long allocCount = 0;   // Allocations made by this thread
+thread_local long allocBytes = 0;   // Bytes requested by this thread
+
+/** @brief Counting replacement for the global allocation function
+ * @param size The number of bytes requested
+ * @return The allocated memory
+*/
+void *operator new(size_t size)
+{
+    allocCount++;
+    allocBytes += size;
+    void *p = malloc(size ? size : 1);
+    if (!p)
+        throw bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const nothrow_t &) noexcept
+{
+    allocCount++;
+    allocBytes += size;
+    return malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const nothrow_t &tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, const nothrow_t &) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, const nothrow_t &) noexcept
+{
+    free(p);
+}
+
+#endif  // TRACK_ALLOCATIONS
+
+/** @brief Checks whether allocations are being counted
+ * @param None
+ * @return True in a -DTRACK_ALLOCATIONS build
+*/
+bool allocationTracking()
+{
+#ifdef TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/** @brief Gets the number of allocations made by the calling thread
+ * @param None
+ * @return The allocation count, 0 when tracking is off
+*/
+long threadAllocations()
+{
+#ifdef TRACK_ALLOCATIONS
+    return allocCount;
+#else
+    return 0;
+#endif
+}
+
+/** @brief Gets the number of bytes allocated by the calling thread
+ * @param None
+ * @return The byte count, 0 when tracking is off
+*/
+long threadAllocatedBytes()
+{
+#ifdef TRACK_ALLOCATIONS
+    return allocBytes;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,15 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef ALLOC_COUNT
+#define ALLOC_COUNT
+
+// Per-thread heap allocation counters. They only count when the program is
+// built with -DTRACK_ALLOCATIONS (make alloc), which replaces the global
+// operator new and delete. Otherwise they always read 0.
+
+bool allocationTracking();
+long threadAllocations();
+long threadAllocatedBytes();
+
+#endif  // ALLOC_COUNT
@@ -0,0 +1,197 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <new>
+#include "sudoku.h"
+#include "board.h"
+#include "logic.h"
+#include "enumerate.h"
+#include "validate.h"
+using namespace std;
+
+/** @brief Reads a caller's puzzle buffer without throwing
+ * @param puzzle SUDOKU_CELLS bytes, '1' to '9' or a blank
+ * @param state Set to the puzzle
+ * @param cells Set to the puzzle with every blank written as '.'
+ * @return SUDOKU_OK, or the reason the puzzle was rejected
+*/
+sudoku_status loadPuzzle(const char *puzzle, boardState &state, char *cells)
+{
+    if (puzzle == NULL)
+        return SUDOKU_BAD_ARGUMENT;
+    state.clear();
+    for (int cell = 0; cell < CellCount; cell++)
+    {
+        char ch = puzzle[cell];
+        if (ch == '.' || ch == '0')
+        {
+            cells[cell] = '.';
+            continue;
+        }
+        if (ch < '1' || ch > '9')
+            return SUDOKU_BAD_INPUT;
+        cells[cell] = ch;
+        state.place(cell, ch - '0');
+    }
+    return hasDuplicates(state) ? SUDOKU_CONFLICT : SUDOKU_OK;
+}
+
+/** @brief Looks for a blank cell that no value fits
+ * @param state The puzzle
+ * @return True if some blank cell's units hold every value
+*/
+bool hasDeadCell(const boardState &state)
+{
+    for (int cell = 0; cell < CellCount; cell++)
+        if (state.cells[cell] == Blank && state.usedMask(cell) == AllValues)
+            return true;
+    return false;
+}
+
+/** @brief Solves a puzzle
+ * @param puzzle The puzzle
+ * @param solution Set to the solution
+ * @param engine The engine to use
+ * @param calls If not null, set to the work spent
+ * @return SUDOKU_OK if solved, otherwise the reason
+*/
+sudoku_status sudoku_solve(const char *puzzle, char *solution, sudoku_engine engine, long *calls)
+{
+    if (solution == NULL)
+        return SUDOKU_BAD_ARGUMENT;
+    try
+    {
+        boardState state;
+        char cells[CellCount];
+        sudoku_status status = loadPuzzle(puzzle, state, cells);
+        if (status != SUDOKU_OK)
+            return status;
+        if (hasDeadCell(state))
+            return SUDOKU_NO_SOLUTION;  // Found without a search
+
+        board b(SquareSize);
+        b.setState(state);
+        engineType chosen = engine == SUDOKU_ENGINE_SAT ? SatEngine : engine == SUDOKU_ENGINE_BAND ? BandEngine
+                                                                                                  : BacktrackEngine;
+        bool solved = b.solve(chosen) && b.isSolved();
+        if (calls != NULL)
+            *calls = b.getCallCount();
+        if (!solved)
+            return SUDOKU_NO_SOLUTION;
+        for (int cell = 0; cell < CellCount; cell++)
+            solution[cell] = (char)('0' + b.getState().cells[cell]);
+        return SUDOKU_OK;
+    }
+    catch (...)
+    {
+        return SUDOKU_INTERNAL_ERROR;   // Nothing may cross the C boundary
+    }
+}
+
+/** @brief Counts the solutions of a puzzle
+ * @param puzzle The puzzle
+ * @param limit Stops after this many, 0 for no limit
+ * @param count Set to the number of solutions found
+ * @return SUDOKU_OK, or the reason the puzzle was rejected
+*/
+sudoku_status sudoku_count(const char *puzzle, long limit, long *count)
+{
+    if (count == NULL || limit < 0)
+        return SUDOKU_BAD_ARGUMENT;
+    try
+    {
+        boardState state;
+        char cells[CellCount];
+        sudoku_status status = loadPuzzle(puzzle, state, cells);
+        if (status == SUDOKU_CONFLICT || (status == SUDOKU_OK && hasDeadCell(state)))
+        {
+            *count = 0;
+            return SUDOKU_OK;
+        }
+        if (status != SUDOKU_OK)
+            return status;
+
+        solutionEnumerator walk;
+        walk.start(state);
+        long found = 0;
+        while ((limit == 0 || found < limit) && walk.next(cells))
+            found++;
+        *count = found;
+        return SUDOKU_OK;
+    }
+    catch (...)
+    {
+        return SUDOKU_INTERNAL_ERROR;
+    }
+}
+
+/** @brief Checks a solution against its puzzle
+ * @param puzzle The puzzle
+ * @param solution The solution to check
+ * @param check If not null, set to the first problem found
+ * @return SUDOKU_OK if the solution is valid, SUDOKU_INVALID_SOLUTION if not
+*/
+sudoku_status sudoku_validate(const char *puzzle, const char *solution, sudoku_check *check)
+{
+    if (solution == NULL)
+        return SUDOKU_BAD_ARGUMENT;
+    boardState state;
+    char cells[CellCount];
+    sudoku_status status = loadPuzzle(puzzle, state, cells);
+    if (status != SUDOKU_OK && status != SUDOKU_CONFLICT)
+        return status;
+
+    validationResult result = validateSolution(cells, solution);
+    if (check != NULL)
+        *check = (sudoku_check)result;  // The enums list the same checks in the same order
+    return result == ValidSolution ? SUDOKU_OK : SUDOKU_INVALID_SOLUTION;
+}
+
+/** @brief Grades a puzzle
+ * @param puzzle The puzzle
+ * @param grade Set to the simplest rules that solve it
+ * @return SUDOKU_OK, or the reason the puzzle was rejected
+*/
+sudoku_status sudoku_grade(const char *puzzle, sudoku_grade_level *grade)
+{
+    if (grade == NULL)
+        return SUDOKU_BAD_ARGUMENT;
+    boardState state;
+    char cells[CellCount];
+    sudoku_status status = loadPuzzle(puzzle, state, cells);
+    if (status != SUDOKU_OK)
+        return status;
+
+    gradeType result = gradePuzzle(state);
+    if (result == InvalidGrade)
+        return SUDOKU_NO_SOLUTION;  // Singles ran into a contradiction
+    *grade = (sudoku_grade_level)result;
+    return SUDOKU_OK;
+}
+
+/** @brief Describes a status
+ * @param status The status
+ * @return A short description
+*/
+const char *sudoku_status_name(sudoku_status status)
+{
+    switch (status)
+    {
+    case SUDOKU_OK:
+        return "ok";
+    case SUDOKU_BAD_ARGUMENT:
+        return "bad argument";
+    case SUDOKU_BAD_INPUT:
+        return "bad input";
+    case SUDOKU_CONFLICT:
+        return "conflicting givens";
+    case SUDOKU_NO_SOLUTION:
+        return "no solution";
+    case SUDOKU_INVALID_SOLUTION:
+        return "invalid solution";
+    case SUDOKU_INTERNAL_ERROR:
+        return "internal error";
+    default:
+        return "unknown status";
+    }
+}
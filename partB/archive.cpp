@@ -0,0 +1,501 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "archive.h"
+using namespace std;
+
+const char ArchiveMagic[4] = { 'S', 'D', 'K', 'B' };
+const unsigned short ArchiveVersion = 1;
+const unsigned short ArchiveHasSolutions = 1;   // Header flag
+const int RowCodeBits = 19; // Enough for 9! - 1
+
+/** @brief Stores a little-endian integer
+ * @param out Where to store it
+ * @param value The value
+ * @param bytes The width in bytes
+ * @return None
+*/
+void putLE(unsigned char *out, unsigned long long value, int bytes)
+{
+    for (int k = 0; k < bytes; k++)
+        out[k] = (unsigned char)(value >> (8 * k));
+}
+
+/** @brief Loads a little-endian integer
+ * @param in Where to load it from
+ * @param bytes The width in bytes
+ * @return The value
+*/
+unsigned long long getLE(const unsigned char *in, int bytes)
+{
+    unsigned long long value = 0;
+    for (int k = bytes - 1; k >= 0; k--)
+        value = (value << 8) | in[k];
+    return value;
+}
+
+// Lookup table for crc32, built once on first use
+struct crcTable
+{
+    unsigned entries[256];
+
+    crcTable()
+    {
+        for (unsigned n = 0; n < 256; n++)
+        {
+            unsigned c = n;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            entries[n] = c;
+        }
+    }
+};
+
+/** @brief Computes a CRC32 (IEEE 802.3)
+ * @param data The bytes to check
+ * @param length The number of bytes
+ * @param crc A previous CRC to continue from
+ * @return The CRC32
+*/
+unsigned crc32(const unsigned char *data, size_t length, unsigned crc)
+{
+    static const crcTable table;
+    crc = ~crc;
+    for (size_t k = 0; k < length; k++)
+        crc = table.entries[(crc ^ data[k]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+/** @brief Computes the permutation code of a solved row
+ * @param row The BoardSize characters of the row
+ * @return The Lehmer code, or -1 if the row is not a permutation
+*/
+long rowCode(const char *row)
+{
+    int used = 0;
+    long code = 0;
+    for (int k = 0; k < BoardSize; k++)
+    {
+        int v = row[k] - '0' - MinValue;
+        if (v < 0 || v >= MaxValue || (used >> v & 1))
+            return -1;
+        int rank = 0;
+        for (int u = 0; u < v; u++)
+            if (!(used >> u & 1))
+                rank++; // Unused values smaller than this one
+        used |= 1 << v;
+        code = code * (BoardSize - k) + rank;
+    }
+    return code;
+}
+
+/** @brief Rebuilds a row from its permutation code
+ * @param code The Lehmer code
+ * @param row The BoardSize characters of the row
+ * @return None
+*/
+void decodeRow(long code, char *row)
+{
+    int ranks[BoardSize];
+    for (int k = BoardSize - 1; k >= 0; k--)
+    {
+        ranks[k] = (int)(code % (BoardSize - k));
+        code /= BoardSize - k;
+    }
+
+    int used = 0;
+    for (int k = 0; k < BoardSize; k++)
+    {
+        int v = 0;
+        for (int rank = ranks[k]; ; v++)
+            if (!(used >> v & 1) && rank-- == 0)
+                break;
+        used |= 1 << v;
+        row[k] = (char)('0' + MinValue + v);
+    }
+}
+
+/** @brief Packs a puzzle record
+ * @param cells The puzzle
+ * @param solution The solved board, or NULL
+ * @param withSolution True if the archive stores solutions
+ * @param out The buffer to write to
+ * @return The number of bytes written, or -1 if a cell is neither a value nor '.'
+*/
+int encodeRecord(const char *cells, const char *solution, bool withSolution, unsigned char *out)
+{
+    memset(out, 0, ClueBitmapBytes);
+    int size = ClueBitmapBytes;
+    int clues = 0;
+    for (int k = 0; k < CellCount; k++)
+    {
+        int v = cells[k] - '0';
+        if (cells[k] == '.')
+            continue;
+        if (v < MinValue || v > MaxValue)
+            return -1;  // Would come back as a different puzzle
+        out[k / 8] |= 1 << (k % 8);
+        if (clues % 2 == 0)
+            out[size] = (unsigned char)v;
+        else
+            out[size++] |= (unsigned char)(v << 4);
+        clues++;
+    }
+    if (clues % 2 == 1)
+        size++;
+
+    if (withSolution)
+    {
+        unsigned char *codes = out + size;
+        memset(codes, 0, SolutionCodeBytes);
+        long rowCodes[BoardSize - 1];
+        bool valid = solution != NULL;
+        for (int r = 0; valid && r < BoardSize - 1; r++)
+            valid = (rowCodes[r] = rowCode(solution + r * BoardSize)) >= 0;
+
+        int bit = 0;
+        for (int r = 0; valid && r < BoardSize - 1; r++)
+            for (int b = 0; b < RowCodeBits; b++, bit++)
+                if (rowCodes[r] >> b & 1)
+                    codes[bit / 8] |= 1 << (bit % 8);
+        size += SolutionCodeBytes;
+    }
+    return size;
+}
+
+/** @brief Unpacks a puzzle record
+ * @param in The start of the record
+ * @param withSolution True if the archive stores solutions
+ * @param cells The puzzle
+ * @param solution The solved board, or NULL to skip it
+ * @return The start of the next record
+*/
+const unsigned char *decodeRecord(const unsigned char *in, bool withSolution, char *cells, char *solution)
+{
+    const unsigned char *digits = in + ClueBitmapBytes;
+    int clues = 0;
+    for (int k = 0; k < CellCount; k++)
+    {
+        if (in[k / 8] >> (k % 8) & 1)
+        {
+            int v = (clues % 2 == 0) ? (digits[clues / 2] & 0xF) : (digits[clues / 2] >> 4);
+            cells[k] = (char)('0' + v);
+            clues++;
+        }
+        else
+            cells[k] = '.';
+    }
+    const unsigned char *next = digits + (clues + 1) / 2;
+    if (!withSolution)
+        return next;
+
+    if (solution != NULL)
+    {
+        bool stored = false;
+        for (int k = 0; k < SolutionCodeBytes; k++)
+            stored |= next[k] != 0;
+
+        if (!stored)
+            memset(solution, '.', CellCount);
+        else
+        {
+            int bit = 0;
+            for (int r = 0; r < BoardSize - 1; r++)
+            {
+                long code = 0;
+                for (int b = 0; b < RowCodeBits; b++, bit++)
+                    code |= (long)(next[bit / 8] >> (bit % 8) & 1) << b;
+                decodeRow(code, solution + r * BoardSize);
+            }
+
+            const int total = (MinValue + MaxValue) * MaxValue / 2;
+            for (int c = 0; c < BoardSize; c++)
+            {
+                int sum = 0;
+                for (int r = 0; r < BoardSize - 1; r++)
+                    sum += solution[r * BoardSize + c] - '0';
+                solution[(BoardSize - 1) * BoardSize + c] = (char)('0' + total - sum);  // Missing value of the column
+            }
+        }
+    }
+    return next + SolutionCodeBytes;
+}
+
+/** @brief Constructor for archiveWriter class
+ * @param None
+ * @return None
+*/
+archiveWriter::archiveWriter() : solutions(false), records(0), blockRecords(0)
+{
+}
+
+/** @brief Creates an archive file
+ * @param path The file to create
+ * @param withSolutions True to store a solution with every puzzle
+ * @return False if the file cannot be created
+*/
+bool archiveWriter::open(const char *path, bool withSolutions)
+{
+    fout.open(path, ios::binary | ios::trunc);
+    if (!fout)
+        return false;
+
+    solutions = withSolutions;
+    records = 0;
+    blockRecords = 0;
+    block.clear();
+    index.clear();
+    unsigned char header[ArchiveHeaderSize] = { 0 };
+    fout.write((const char *)header, ArchiveHeaderSize);  // Filled in by close()
+    return (bool)fout;
+}
+
+/** @brief Appends a puzzle
+ * @param cells The puzzle
+ * @param solution The solved board, or NULL
+ * @return False if the puzzle cannot be stored, true otherwise
+*/
+bool archiveWriter::add(const char *cells, const char *solution)
+{
+    unsigned char record[MaxRecordBytes];
+    int size = encodeRecord(cells, solution, solutions, record);
+    if (size < 0)
+        return false;
+    block.insert(block.end(), record, record + size);
+    records++;
+    if (++blockRecords == ArchiveBlockRecords)
+        flushBlock();
+    return true;
+}
+
+/** @brief Writes the block being filled and indexes it
+ * @param None
+ * @return None
+*/
+void archiveWriter::flushBlock()
+{
+    if (blockRecords == 0)
+        return;
+
+    unsigned char entry[ArchiveIndexEntrySize];
+    putLE(entry, (unsigned long long)fout.tellp(), 8);
+    putLE(entry + 8, block.size(), 4);
+    putLE(entry + 12, crc32(&block[0], block.size()), 4);
+    index.insert(index.end(), entry, entry + ArchiveIndexEntrySize);
+
+    fout.write((const char *)&block[0], block.size());
+    block.clear();
+    blockRecords = 0;
+}
+
+/** @brief Finishes the archive
+ * @param None
+ * @return False if writing failed
+*/
+bool archiveWriter::close()
+{
+    flushBlock();
+    unsigned long long indexOffset = (unsigned long long)fout.tellp();
+    if (!index.empty())
+        fout.write((const char *)&index[0], index.size());
+
+    unsigned char header[ArchiveHeaderSize] = { 0 };
+    memcpy(header, ArchiveMagic, 4);
+    putLE(header + 4, ArchiveVersion, 2);
+    putLE(header + 6, solutions ? ArchiveHasSolutions : 0, 2);
+    putLE(header + 8, records, 8);
+    putLE(header + 16, ArchiveBlockRecords, 4);
+    putLE(header + 20, index.size() / ArchiveIndexEntrySize, 4);
+    putLE(header + 24, indexOffset, 8);
+    putLE(header + ArchiveHeaderSize - 4, crc32(header, ArchiveHeaderSize - 4), 4);
+    fout.seekp(0);
+    fout.write((const char *)header, ArchiveHeaderSize);
+    fout.close();
+    return !fout.fail();
+}
+
+/** @brief Gets the number of puzzles added
+ * @param None
+ * @return The puzzle count
+*/
+long archiveWriter::size() const
+{
+    return records;
+}
+
+/** @brief Constructor for puzzleArchive class
+ * @param None
+ * @return None
+*/
+puzzleArchive::puzzleArchive() : base(NULL), length(0), records(0), blocks(0), solutions(false), indexBase(NULL)
+{
+}
+
+/** @brief Destructor for puzzleArchive class
+ * @param None
+ * @return None
+*/
+puzzleArchive::~puzzleArchive()
+{
+    if (base != NULL)
+        munmap((void *)base, length);
+}
+
+/** @brief Checks whether a file is an archive
+ * @param path The file to check
+ * @return True if the file starts with the archive magic
+*/
+bool puzzleArchive::isArchive(const char *path)
+{
+    char magic[4];
+    ifstream fin(path, ios::binary);
+    return fin.read(magic, 4) && memcmp(magic, ArchiveMagic, 4) == 0;
+}
+
+/** @brief Maps an archive and checks its header and index
+ * @param path The file to open
+ * @param error Set to the reason when the archive cannot be used
+ * @return True if the archive is usable
+*/
+bool puzzleArchive::open(const char *path, string &error)
+{
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        error = "cannot open file";
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < ArchiveHeaderSize)
+    {
+        ::close(fd);
+        error = "file too short";
+        return false;
+    }
+
+    length = (size_t)st.st_size;
+    void *mapped = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);    // The mapping stays valid
+    if (mapped == MAP_FAILED)
+    {
+        error = "cannot map file";
+        return false;
+    }
+    base = (const unsigned char *)mapped;
+    madvise(mapped, length, MADV_SEQUENTIAL);
+
+    if (memcmp(base, ArchiveMagic, 4) != 0 || getLE(base + 4, 2) != ArchiveVersion)
+    {
+        error = "not a version 1 archive";
+        return false;
+    }
+    if (getLE(base + ArchiveHeaderSize - 4, 4) != crc32(base, ArchiveHeaderSize - 4))
+    {
+        error = "header checksum mismatch";
+        return false;
+    }
+
+    solutions = (getLE(base + 6, 2) & ArchiveHasSolutions) != 0;
+    records = (long)getLE(base + 8, 8);
+    blocks = (int)getLE(base + 20, 4);
+    unsigned long long indexOffset = getLE(base + 24, 8);
+    if (getLE(base + 16, 4) != (unsigned long long)ArchiveBlockRecords ||
+        indexOffset + (unsigned long long)blocks * ArchiveIndexEntrySize > length ||
+        (long)blocks != (records + ArchiveBlockRecords - 1) / ArchiveBlockRecords)
+    {
+        error = "corrupt header";
+        return false;
+    }
+    indexBase = base + indexOffset;
+
+    for (int b = 0; b < blocks; b++)
+    {
+        const unsigned char *entry = indexBase + b * ArchiveIndexEntrySize;
+        if (getLE(entry, 8) + getLE(entry + 8, 4) > indexOffset)
+        {
+            error = "corrupt block index";
+            return false;
+        }
+    }
+    return true;
+}
+
+/** @brief Gets the number of puzzles
+ * @param None
+ * @return The puzzle count
+*/
+long puzzleArchive::size() const
+{
+    return records;
+}
+
+/** @brief Checks whether solutions are stored
+ * @param None
+ * @return True if every record carries a solution code
+*/
+bool puzzleArchive::hasSolutions() const
+{
+    return solutions;
+}
+
+/** @brief Gets the number of blocks
+ * @param None
+ * @return The block count
+*/
+int puzzleArchive::blockCount() const
+{
+    return blocks;
+}
+
+/** @brief Checks the CRC32 of a block
+ * @param b The block number
+ * @return True if the block is intact
+*/
+bool puzzleArchive::verifyBlock(int b) const
+{
+    const unsigned char *entry = indexBase + b * ArchiveIndexEntrySize;
+    return crc32(blockData(b), getLE(entry + 8, 4)) == getLE(entry + 12, 4);
+}
+
+/** @brief Gets the first record of a block
+ * @param b The block number
+ * @return A pointer into the mapped file
+*/
+const unsigned char *puzzleArchive::blockData(int b) const
+{
+    return base + getLE(indexBase + b * ArchiveIndexEntrySize, 8);
+}
+
+/** @brief Gets the number of records in a block
+ * @param b The block number
+ * @return The record count
+*/
+int puzzleArchive::blockSize(int b) const
+{
+    return b < blocks - 1 ? ArchiveBlockRecords : (int)(records - (long)(blocks - 1) * ArchiveBlockRecords);
+}
+
+/** @brief Reads one puzzle by position
+ * @param index The puzzle number, from 0
+ * @param cells The puzzle
+ * @param solution The solved board, or NULL to skip it
+ * @return False if index is out of range
+*/
+bool puzzleArchive::getPuzzle(long index, char *cells, char *solution) const
+{
+    if (index < 0 || index >= records)
+        return false;
+
+    int b = (int)(index / ArchiveBlockRecords);
+    const unsigned char *p = blockData(b);
+    for (long k = (long)b * ArchiveBlockRecords; k < index; k++)
+        p = decodeRecord(p, solutions, cells, NULL);    // Skips earlier records in the block
+    decodeRecord(p, solutions, cells, solution);
+    return true;
+}
@@ -0,0 +1,113 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef PUZZLE_ARCHIVE
+#define PUZZLE_ARCHIVE
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "board.h"
+using namespace std;
+
+// Packed binary puzzle archive.
+//
+//   header   48 bytes: "SDKB", version, flags, record count, records per
+//            block, block count, index offset, CRC32 of the header
+//   blocks   records back to back. A record is an 81-bit clue bitmap
+//            (11 bytes) followed by the clue values packed 4 bits each,
+//            then, if the archive has solutions, 19 bytes holding the
+//            permutation (Lehmer) codes of rows 1 to 8 at 19 bits each.
+//            Row 9 follows from the columns. All zero codes mean the
+//            puzzle has no stored solution
+//   index    16 bytes per block: offset, length and CRC32 of the block
+//
+// All integers are little-endian. Cells are BoardSize * BoardSize
+// characters row by row, '.' for a blank, as in sudoku.txt.
+
+const int ArchiveHeaderSize = 48;
+const int ArchiveIndexEntrySize = 16;
+const int ArchiveBlockRecords = 4096;   // Records per block
+const int ClueBitmapBytes = (CellCount + 7) / 8;
+const int SolutionCodeBytes = 19;
+const int MaxRecordBytes = ClueBitmapBytes + (CellCount + 1) / 2 + SolutionCodeBytes;
+
+unsigned crc32(const unsigned char *data, size_t length, unsigned crc = 0);
+
+int encodeRecord(const char *cells, const char *solution, bool withSolution, unsigned char *out);
+// packs a puzzle (and solution, which may be NULL) into out. returns the
+// number of bytes written, at most MaxRecordBytes, or -1 if a cell is
+// neither a value nor '.'; nothing else can be stored
+
+const unsigned char *decodeRecord(const unsigned char *in, bool withSolution, char *cells, char *solution);
+// unpacks one record. solution may be NULL; it is filled with '.' when no
+// solution is stored. returns the start of the next record
+
+class archiveWriter
+{
+public:
+    archiveWriter();
+
+    bool open(const char *path, bool withSolutions);
+    // creates the archive. returns false if the file cannot be written
+
+    bool add(const char *cells, const char *solution);
+    // appends a puzzle; solution may be NULL. returns false, adding
+    // nothing, if a cell is neither a value nor '.'
+
+    bool close();
+    // writes the last block, the index and the header
+
+    long size() const;
+    // number of puzzles added
+
+private:
+    ofstream fout;
+    bool solutions;
+    long records;
+    vector<unsigned char> block;    // Records of the block being filled
+    int blockRecords;
+    vector<unsigned char> index;    // Encoded index entries
+
+    void flushBlock();
+};
+
+class puzzleArchive
+{
+public:
+    puzzleArchive();
+    ~puzzleArchive();
+
+    static bool isArchive(const char *path);
+    // true if the file starts with the archive magic
+
+    bool open(const char *path, string &error);
+    // maps the archive read-only and checks the header and index
+
+    long size() const;
+    bool hasSolutions() const;
+    int blockCount() const;
+
+    bool verifyBlock(int b) const;
+    // checks the CRC32 of a block
+
+    const unsigned char *blockData(int b) const;
+    int blockSize(int b) const;
+    // records in block b
+
+    bool getPuzzle(long index, char *cells, char *solution) const;
+    // random access by decoding within the record's block
+
+private:
+    const unsigned char *base;  // Mapped file
+    size_t length;
+    long records;
+    int blocks;
+    bool solutions;
+    const unsigned char *indexBase;
+
+    puzzleArchive(const puzzleArchive &);
+    puzzleArchive &operator=(const puzzleArchive &);
+};
+
+#endif  // PUZZLE_ARCHIVE
@@ -0,0 +1,272 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include "band.h"
+using namespace std;
+
+constexpr bandTables bandSolver::tables;
+
+/** @brief Spreads a mask of columns over the three rows of a band
+ * @param columns The columns
+ * @return The cells of the band in those columns
+*/
+inline unsigned spreadColumns(unsigned columns)
+{
+    return columns | columns << BoardSize | columns << (2 * BoardSize);
+}
+
+/** @brief Constructor for bandSolver class
+ * @param None
+ * @return None
+*/
+bandSolver::bandSolver() : transposed(false), nodes(0), backtracks(0), forced(0)
+{
+}
+
+/** @brief Lists the placements of every value in every band that fit the givens
+ * @param puzzle The givens
+ * @param byStacks True to read bands as stacks
+ * @return The number of placements listed
+ * @note Also clears the choices of the last solve
+*/
+long bandSolver::findOptions(const boardState &puzzle, bool byStacks)
+{
+    unsigned clues[BandCount][MaxValue] = {{0}};    // Cells of the givens of each value
+    unsigned givens[BandCount] = {0};
+    unsigned clueColumns[BandCount][MaxValue] = {{0}};
+    for (int cell = 0; cell < CellCount; cell++)
+    {
+        if (puzzle.cells[cell] == Blank)
+            continue;
+        int r = cell / BoardSize, c = cell % BoardSize;
+        if (byStacks)
+            swap(r, c);
+        int b = r / SquareSize, v = puzzle.cells[cell] - MinValue;
+        unsigned bit = 1u << (r % SquareSize * BoardSize + c);
+        clues[b][v] |= bit;
+        givens[b] |= bit;
+        clueColumns[b][v] |= 1u << c;
+    }
+
+    long total = 0;
+    for (int b = 0; b < BandCount; b++)
+        for (int v = 0; v < MaxValue; v++)
+        {
+            unsigned otherColumns = 0;  // Columns the value holds in the other bands
+            for (int other = 0; other < BandCount; other++)
+                if (other != b)
+                    otherColumns |= clueColumns[other][v];
+            unsigned blocked = (givens[b] & ~clues[b][v]) | spreadColumns(otherColumns);
+
+            int count = 0;
+            for (int p = 0; p < BandPatterns; p++)
+            {
+                unsigned cells = (unsigned)(tables.masks[p] & AllBandCells);
+                if ((cells & clues[b][v]) == clues[b][v] && (cells & blocked) == 0)
+                    options[b][v][count++] = (unsigned short)p;
+            }
+            optionCount[b][v] = count;
+            chosen[b][v] = -1;
+            used[b][v] = 0;
+            total += count;
+        }
+    return total;
+}
+
+/** @brief Places a value in a band
+ * @param band The band
+ * @param value The value, 0 to MaxValue - 1
+ * @param pattern The placement, which must fit what is in use
+ * @return None
+*/
+inline void bandSolver::choose(int band, int value, int pattern)
+{
+    unsigned long long mask = tables.masks[pattern];
+    unsigned long long cells = mask & AllBandCells, columns = mask & ~(unsigned long long)AllBandCells;
+    chosen[band][value] = (short)pattern;
+    for (int v = 0; v < MaxValue; v++)
+        used[band][v] |= cells;     // No other value may share the cells
+    for (int b = 0; b < BandCount; b++)
+        used[b][value] |= columns;  // Nor may the value reuse the columns
+}
+
+/** @brief Takes a value back out of a band
+ * @param band The band
+ * @param value The value, 0 to MaxValue - 1
+ * @param pattern The placement made by choose
+ * @return None
+*/
+inline void bandSolver::unchoose(int band, int value, int pattern)
+{
+    unsigned long long mask = tables.masks[pattern];
+    unsigned long long cells = mask & AllBandCells, columns = mask & ~(unsigned long long)AllBandCells;
+    chosen[band][value] = -1;
+    for (int v = 0; v < MaxValue; v++)
+        used[band][v] ^= cells;
+    for (int b = 0; b < BandCount; b++)
+        used[b][value] ^= columns;
+}
+
+/** @brief Checks whether a value can still be placed over a cell
+ * @param band The band
+ * @param value The value, 0 to MaxValue - 1
+ * @param cell The cell's bit in the band
+ * @return True if some placement left takes the cell
+*/
+inline bool bandSolver::takesCell(int band, int value, unsigned cell) const
+{
+    unsigned long long inUse = used[band][value];
+    for (int k = 0; k < optionCount[band][value]; k++)
+        if ((tables.masks[options[band][value][k]] & (inUse | cell)) == cell)
+            return true;
+    return false;
+}
+
+/** @brief Places the remaining values in their bands
+ * @param placed The number of values placed so far, over all bands
+ * @return True if every value was placed, false otherwise
+ * @note Each call counts the placements left for every value in every
+ *       band and gives up if one has none or some cell of a band cannot
+ *       be covered. A cell only one placement can take forces that
+ *       placement; otherwise the search branches on the value and band
+ *       with the fewest placements
+*/
+bool bandSolver::search(int placed)
+{
+    nodes++;
+    if (placed == BandCount * MaxValue)
+        return true;
+
+    int bestBand = -1, bestValue = 0, bestCount = BandPatterns + 1;
+    int onlyBand = 0, onlyCell = -1;  // A cell only one placement left can take
+    unsigned long long reach[MaxValue] = {0};   // Columns each value can still take
+    for (int b = 0; b < BandCount; b++)
+    {
+        unsigned taken = (unsigned)used[b][0] & AllBandCells;
+        unsigned cover = taken, shared = 0;   // Cells some placement left can take, and two or more
+        for (int v = 0; v < MaxValue; v++)
+        {
+            if (chosen[b][v] >= 0)
+                continue;
+            unsigned long long inUse = used[b][v];
+            const unsigned short *list = options[b][v];
+            int count = 0;
+            for (int k = 0; k < optionCount[b][v]; k++)
+            {
+                unsigned long long mask = tables.masks[list[k]];
+                if ((mask & inUse) == 0)
+                {
+                    count++;
+                    shared |= cover & (unsigned)mask;
+                    cover |= (unsigned)mask;
+                    reach[v] |= mask;
+                }
+            }
+            if (count == 0)
+                return false;
+            if (count < bestCount)
+            {
+                bestBand = b;
+                bestValue = v;
+                bestCount = count;
+            }
+        }
+        if ((cover & AllBandCells) != AllBandCells)
+            return false;
+        unsigned once = ~taken & ~shared & AllBandCells;
+        if (once != 0 && onlyCell < 0)
+        {
+            onlyCell = __builtin_ctz(once);
+            onlyBand = b;
+        }
+    }
+    for (int v = 0; v < MaxValue; v++)
+        if (((reach[v] | used[0][v]) >> BandCells) != AllValues)
+            return false;   // Some column the value needs is out of reach
+
+    int b = bestBand, v = bestValue;
+    unsigned only = 0;  // A cell the chosen placement must take
+    if (bestCount > 1 && onlyCell >= 0)
+    {
+        b = onlyBand;
+        only = 1u << onlyCell;
+        for (v = 0; v < MaxValue; v++)
+            if (chosen[b][v] < 0 && takesCell(b, v, only))
+                break;  // The one value that can still take the cell
+    }
+    if (bestCount == 1 || only != 0)
+        forced++;
+
+    unsigned long long inUse = used[b][v];
+    for (int k = 0; k < optionCount[b][v]; k++)
+    {
+        int p = options[b][v][k];
+        if ((tables.masks[p] & (inUse | only)) != only)
+            continue;
+        choose(b, v, p);
+        if (search(placed + 1))
+            return true;
+        unchoose(b, v, p);
+        backtracks++;
+    }
+    return false;
+}
+
+/** @brief Solves a puzzle
+ * @param puzzle The givens, filled in if there is a solution
+ * @return True if the puzzle is solved, false otherwise
+*/
+bool bandSolver::solve(boardState &puzzle)
+{
+    nodes = backtracks = forced = 0;
+    long byStacks = findOptions(puzzle, true);
+    long byRows = findOptions(puzzle, false);
+    transposed = byStacks < byRows;
+    if (transposed)
+        findOptions(puzzle, true);  // Stacks start with fewer placements
+
+    if (!search(0))
+        return false;
+
+    for (int b = 0; b < BandCount; b++)
+        for (int v = 0; v < MaxValue; v++)
+        {
+            unsigned cells = (unsigned)(tables.masks[chosen[b][v]] & AllBandCells);
+            for (; cells != 0; cells &= cells - 1)
+            {
+                int bit = __builtin_ctz(cells);
+                int r = b * SquareSize + bit / BoardSize, c = bit % BoardSize;
+                int cell = transposed ? c * BoardSize + r : r * BoardSize + c;
+                if (puzzle.cells[cell] == Blank)
+                    puzzle.place(cell, v + MinValue);
+            }
+        }
+    return true;
+}
+
+/** @brief Gets the number of calls of the search in the last solve
+ * @param None
+ * @return The number of calls
+*/
+long bandSolver::getNodes() const
+{
+    return nodes;
+}
+
+/** @brief Gets the number of placements taken back in the last solve
+ * @param None
+ * @return The number of placements
+*/
+long bandSolver::getBacktracks() const
+{
+    return backtracks;
+}
+
+/** @brief Gets the number of forced placements in the last solve
+ * @param None
+ * @return The number of placements
+*/
+long bandSolver::getForced() const
+{
+    return forced;
+}
@@ -0,0 +1,95 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef BAND_SOLVER
+#define BAND_SOLVER
+
+#include "board.h"
+using namespace std;
+
+// A table-driven engine that fills the board a band (three rows) at a
+// time. In a band, a value sits once in each row and once in each square,
+// so it can only take one of BandPatterns placements. Those placements are
+// built by constexpr code into one 64-bit mask each: the band's cells in
+// the low BandCells bits and the columns above them. Choosing a placement
+// for each value in each band is then a search over table entries, and
+// every check is one AND against what the band and the value already use.
+//
+// Bands may also be read as stacks (three columns) by transposing the
+// puzzle; the solver takes whichever way leaves fewer placements to start.
+
+const int BandCount = BoardSize / SquareSize;   // Bands of the board
+const int BandCells = SquareSize * BoardSize;   // Cells in a band
+const int BandPatterns = BoardSize * (BoardSize - SquareSize) * (BoardSize - 2 * SquareSize);
+const unsigned AllBandCells = (1u << BandCells) - 1;
+
+// Every placement of one value in a band. Bit r * BoardSize + c of a mask
+// is the cell in row r of the band and column c; bit BandCells + c is
+// column c.
+struct bandTables
+{
+    unsigned long long masks[BandPatterns];
+};
+
+/** @brief Builds the placements of a value in a band
+ * @param None
+ * @return The tables
+ * @note Evaluated by the compiler
+*/
+constexpr bandTables makeBandTables()
+{
+    bandTables t{};
+    int p = 0;
+    for (int c0 = 0; c0 < BoardSize; c0++)
+        for (int c1 = 0; c1 < BoardSize; c1++)
+            for (int c2 = 0; c2 < BoardSize; c2++)
+            {
+                int s0 = c0 / SquareSize, s1 = c1 / SquareSize, s2 = c2 / SquareSize;
+                if (s0 == s1 || s0 == s2 || s1 == s2)
+                    continue;   // Two rows in one square
+                unsigned cells = (1u << c0) | (1u << (BoardSize + c1)) | (1u << (2 * BoardSize + c2));
+                unsigned columns = (1u << c0) | (1u << c1) | (1u << c2);
+                t.masks[p++] = cells | (unsigned long long)columns << BandCells;
+            }
+    return t;
+}
+
+class bandSolver
+{
+public:
+    bandSolver();
+
+    bool solve(boardState &puzzle);
+    // fills every blank of puzzle if it has a solution. returns false,
+    // leaving puzzle alone, if it has none
+
+    long getNodes() const;
+    long getBacktracks() const;
+    long getForced() const;
+    // search statistics for the last call to solve(): calls of the
+    // search, placements taken back, and placements made because they
+    // were the only one left for their value and band
+
+    static constexpr bandTables tables = makeBandTables();
+
+private:
+    unsigned short options[BandCount][MaxValue][BandPatterns];  // Placements that fit the givens
+    int optionCount[BandCount][MaxValue];
+    short chosen[BandCount][MaxValue];  // Placement of each value in each band, or -1
+    unsigned long long used[BandCount][MaxValue];   // Cells of the band and columns of the value in use
+    bool transposed;    // True when bands are read as stacks
+    long nodes;
+    long backtracks;
+    long forced;
+
+    long findOptions(const boardState &puzzle, bool byStacks);
+    void choose(int band, int value, int pattern);
+    void unchoose(int band, int value, int pattern);
+    bool takesCell(int band, int value, unsigned cell) const;
+    bool search(int placed);
+
+    bandSolver(const bandSolver &);
+    bandSolver &operator=(const bandSolver &);
+};
+
+#endif  // BAND_SOLVER
@@ -1,53 +1,19 @@
 // Matthew Egg and Charles Daigle
 // EECE 2560 Project 4 - Part B
 
-#include <iostream>
-#include <vector>
-#include "d_matrix.h"
-#include "d_except.h"
-#include <fstream>
+#include <cstring>
+#include "board.h"
+#include "band.h"
+#include "sat.h"
 using namespace std;
 
-typedef int ValueType;
-int callCount = 0;
-int totalCallCount = 0;
-int totalSolved = 0;
-const int Blank = -1;
-const int SquareSize = 3;
-const int BoardSize = SquareSize * SquareSize;
-const int MinValue = 1;
-const int MaxValue = 9;
-
-class board
-{
-public:
-    board(int);
-    void clear();
-    void initialize(ifstream &fin);
-    void print();
-    void printConflicts();
-    bool isBlank(int, int);
-    ValueType getCell(int, int);
-    void setCell(int, int, int);
-    void clearCell(int, int);
-    bool isSolved();
-    pair<int, int> findEmptyCell();
-    bool solveBoard();
-
-private:
-    matrix<ValueType> value;
-    vector<vector<vector<int>>> conflicts;
-
-    void updateConflicts(int, int, int, int);
-    void undoChanges(int, int, int, int);
-};
-
 /** @brief Constructor for board class
  * @param sqSize The size of the board
  * @return None
 */
-board::board(int sqSize) : value(BoardSize + 1, BoardSize + 1), conflicts(BoardSize + 1, vector<vector<int>>(BoardSize + 1, vector<int>(MaxValue + 1, 0)))  // BoardSize+1 by BoardSize+1 matrix, initialized to 0
+board::board(int sqSize) : callCount(0)
 {
+    memset(cageOf, -1, sizeof(cageOf));    // No cages
     clear();
 }
 
@@ -57,16 +23,8 @@ board::board(int sqSize) : value(BoardSize + 1, BoardSize + 1), conflicts(BoardS
 */
 void board::clear()
 {
-    for (int i = 1; i <= BoardSize; i++)
-        for (int j = 1; j <= BoardSize; j++)
-        {
-            value[i][j] = Blank;    // Sets all cells to blank
-        }
-
-    for (int i = 1; i <= BoardSize; i++)
-        for (int j = 1; j <= BoardSize; j++)
-            for (int k = 1; k <= MaxValue; k++)
-                conflicts[i][j][k] = 0; // Sets all conflicts to 0
+    state.clear();  // Sets all cells to blank and all conflicts to 0
+    resetCages();   // Keeps the cages but empties them
 }
 
 /** @brief Initializes the board
@@ -86,30 +44,52 @@ void board::initialize(ifstream &fin)
         }
 }
 
-/** @brief Updates the conflicts matrix
+/** @brief Initializes the board from a parsed record
+ * @param cells The BoardSize * BoardSize characters of the board, row by row
+ * @return None
+*/
+void board::initialize(const char *cells)
+{
+    clear();    // Clears the board
+    for (int i = 1; i <= BoardSize; i++)
+        for (int j = 1; j <= BoardSize; j++)
+        {
+            char ch = cells[(i - 1) * BoardSize + (j - 1)];
+            if (ch != '.' && (ch < '0' + MinValue || ch > '0' + MaxValue))
+                throw rangeError("bad character in board::initialize");  // '/' would otherwise read as Blank
+            if (ch != '.')  // If the character is not a period, set the cell to the character
+                setCell(i, j, ch - '0');    // Converts the character to an integer
+        }
+}
+
+/** @brief Updates the conflict counts
  * @param i The row to update
  * @param j The column to update
  * @param val The value to update
- * @param increment The amount to increment by
+ * @param increment 1 to place val in the cell, -1 to remove it
  * @return None
 */
 void board::updateConflicts(int i, int j, int val, int increment)
 {
-    for (int k = 1; k <= BoardSize; k++)
+    int cell = (i - 1) * BoardSize + (j - 1);
+    if (increment > 0)
+        state.place(cell, val); // Counts val in the row, column and square
+    else
+        state.remove(cell);     // Uncounts val from the row, column and square
+
+    if (cageOf[cell] >= 0)
     {
-        conflicts[i][k][val] += increment;  // Increments the row conflicts
-        conflicts[k][j][val] += increment;  // Increments the column conflicts
+        killerCage &cage = cages[cageOf[cell]];
+        cage.placedSum += increment * val;
+        cage.placed += increment;
+        if (increment > 0)
+            cage.used |= 1 << (val - MinValue);
+        else
+            cage.used &= ~(1 << (val - MinValue));
     }
-
-    int rowStart = 3 * ((i - 1) / 3) + 1;   // Calculates the starting row of the square
-    int colStart = 3 * ((j - 1) / 3) + 1;   // Calculates the starting column of the square
-
-    for (int row = rowStart; row < rowStart + SquareSize; row++)
-        for (int col = colStart; col < colStart + SquareSize; col++)
-            conflicts[row][col][val] += increment;  // Increments the square conflicts
 }
 
-/** @brief Undoes changes to the conflicts matrix
+/** @brief Undoes changes to the conflict counts
  * @param i The row to update
  * @param j The column to update
  * @param val The value to update
@@ -129,14 +109,18 @@ void board::undoChanges(int i, int j, int val, int increment)
 */
 void board::setCell(int i, int j, int val)
 {
-    int oldVal = value[i][j];
-    value[i][j] = val;
+    if (i < 1 || i > BoardSize || j < 1 || j > BoardSize)
+        throw rangeError("bad cell in setCell");    // Throws an error if the cell is out of range
+    if (val != Blank && (val < MinValue || val > MaxValue))
+        throw rangeError("bad value in setCell");   // Throws an error if the value is out of range
+
+    int oldVal = getCell(i, j);
 
     if (oldVal != Blank)    // If the old value is not blank, undo changes
-        undoChanges(i, j, oldVal, 1);   // Undoes changes to the conflicts matrix
+        undoChanges(i, j, oldVal, 1);   // Undoes changes to the conflicts
 
     if (val != Blank)   // If the new value is not blank, update conflicts
-        updateConflicts(i, j, val, 1);  // Updates the conflicts matrix
+        updateConflicts(i, j, val, 1);  // Updates the conflicts
 }
 
 /** @brief Clears a cell
@@ -146,10 +130,9 @@ void board::setCell(int i, int j, int val)
 */
 void board::clearCell(int i, int j)
 {
-    int val = value[i][j];  // Gets the value of the cell
-    value[i][j] = Blank;    // Sets the cell to blank
+    int val = getCell(i, j);    // Gets the value of the cell
     if (val != Blank)
-        undoChanges(i, j, val, 1);  // Undoes changes to the conflicts matrix
+        undoChanges(i, j, val, 1);  // Blanks the cell and undoes changes to the conflicts
 }
 
 /** @brief Checks if a cell is blank
@@ -159,7 +142,7 @@ void board::clearCell(int i, int j)
 */
 bool board::isBlank(int i, int j)
 {
-    return (value[i][j] == Blank);  // Returns true if the cell is blank, false otherwise
+    return (state.cells[(i - 1) * BoardSize + (j - 1)] == Blank);  // Returns true if the cell is blank, false otherwise
 }
 
 /** @brief Gets the value of a cell
@@ -170,7 +153,7 @@ bool board::isBlank(int i, int j)
 ValueType board::getCell(int i, int j)
 {
     if (i >= 1 && i <= BoardSize && j >= 1 && j <= BoardSize)
-        return value[i][j]; // Returns the value of the cell
+        return state.cells[(i - 1) * BoardSize + (j - 1)]; // Returns the value of the cell
     else
         throw rangeError("bad value in getCell");   // Throws an error if the cell is out of range
 }
@@ -181,51 +164,40 @@ ValueType board::getCell(int i, int j)
 */
 bool board::isSolved()
 {
-    for (int i = 1; i <= BoardSize; i++)
-    {
-        for (int j = 1; j <= BoardSize; j++)
-        {
-            if (isBlank(i, j))
-            {
-                return false;   // Returns false if the board is not solved
-            }
-        }
-    }
-
-    return true;
+    return state.filled == CellCount;   // Returns false if any cell is blank
 }
 
 /** @brief Prints the board
- * @param None
+ * @param out The stream to print to
  * @return None
 */
-void board::print()
+void board::print(ostream &out)
 {
     for (int i = 1; i <= BoardSize; i++)
     {
         if ((i - 1) % SquareSize == 0)
         {
-            cout << " -";   // Prints the top of the square
+            out << " -";   // Prints the top of the square
             for (int j = 1; j <= BoardSize; j++)
-                cout << "---";  // Prints the top of the square
-            cout << "-" << endl;    // Prints the top of the square
+                out << "---";  // Prints the top of the square
+            out << "-" << endl;    // Prints the top of the square
         }
         for (int j = 1; j <= BoardSize; j++)
         {
             if ((j - 1) % SquareSize == 0)
-                cout << "|";    // Prints the side of the square
+                out << "|";    // Prints the side of the square
             if (!isBlank(i, j))
-                cout << " " << getCell(i, j) << " ";
+                out << " " << getCell(i, j) << " ";
             else
-                cout << "   ";
+                out << "   ";
         }
-        cout << "|" << endl;    // Prints the side of the square
+        out << "|" << endl;    // Prints the side of the square
     }
 
-    cout << " -";   // Prints the bottom of the square
+    out << " -";   // Prints the bottom of the square
     for (int j = 1; j <= BoardSize; j++)
-        cout << "---";  // Prints the bottom of the square
-    cout << "-" << endl;    // Prints the bottom of the square
+        out << "---";  // Prints the bottom of the square
+    out << "-" << endl;    // Prints the bottom of the square
 }
 
 /** @brief Prints the conflicts matrix
@@ -241,12 +213,199 @@ void board::printConflicts()
         {
             cout << "Cell (" << i << ", " << j << "): ";    // Prints the cell
             for (int k = 1; k <= MaxValue; k++)
-                cout << conflicts[i][j][k] << " ";  // Prints the conflicts matrix
+                cout << state.conflictCount((i - 1) * BoardSize + (j - 1), k) << " ";  // Prints the conflicts
             cout << endl;
         }
     }
 }
 
+/** @brief Gets the number of recursive calls
+ * @param None
+ * @return The number of calls since the last reset
+*/
+int board::getCallCount() const
+{
+    return callCount;
+}
+
+/** @brief Resets the recursive call counter
+ * @param None
+ * @return None
+*/
+void board::resetCallCount()
+{
+    callCount = 0;
+}
+
+/** @brief Gets the snapshot behind the board
+ * @param None
+ * @return The board contents
+*/
+const boardState &board::getState() const
+{
+    return state;
+}
+
+/** @brief Replaces the board contents with a snapshot
+ * @param snapshot The contents to copy in
+ * @return None
+*/
+void board::setState(const boardState &snapshot)
+{
+    state = snapshot;
+    resetCages();
+    for (int cell = 0; cell < CellCount; cell++)
+        if (cageOf[cell] >= 0 && state.cells[cell] != Blank)
+        {
+            killerCage &cage = cages[cageOf[cell]];
+            cage.placedSum += state.cells[cell];
+            cage.placed++;
+            cage.used |= 1 << (state.cells[cell] - MinValue);
+        }
+}
+
+// Values usable by the open cells of a cage, for every number of open
+// cells, remaining sum and set of values not yet in the cage
+struct cageTable
+{
+    unsigned short options[MaxValue + 1][MaxCageSum + 1][AllValues + 1];
+
+    cageTable()
+    {
+        memset(options, 0, sizeof(options));
+        for (int avail = 0; avail <= AllValues; avail++)
+            for (int set = avail; ; set = (set - 1) & avail) // Every subset of avail
+            {
+                int cells = 0, sum = 0;
+                for (int v = 0; v < MaxValue; v++)
+                    if (set >> v & 1)
+                    {
+                        cells++;
+                        sum += v + MinValue;
+                    }
+                options[cells][sum][avail] |= set;
+                if (set == 0)
+                    break;
+            }
+    }
+};
+
+/** @brief Looks up the values that can complete a cage
+ * @param cells The number of open cells
+ * @param sum The sum they must add up to
+ * @param available The values not yet used in the cage
+ * @return The union of the fitting value sets, 0 if there is none
+*/
+unsigned short cageOptions(int cells, int sum, unsigned short available)
+{
+    static const cageTable table;
+    if (cells < 0 || cells > MaxValue || sum < 0 || sum > MaxCageSum)
+        return 0;
+    return table.options[cells][sum][available & AllValues];
+}
+
+/** @brief Adds a killer cage
+ * @param sum The sum of the cage
+ * @param cells The row and column of every cell in the cage
+ * @return False if a cell is already caged or listed twice or no values fit, true otherwise
+*/
+bool board::addCage(int sum, const vector<pair<int, int> > &cells)
+{
+    if (cells.empty() || (int)cells.size() > MaxValue || cageOptions((int)cells.size(), sum, AllValues) == 0)
+        return false;
+    bool listed[CellCount] = {false};
+    for (size_t k = 0; k < cells.size(); k++)
+    {
+        int i = cells[k].first, j = cells[k].second;
+        if (i < 1 || i > BoardSize || j < 1 || j > BoardSize)
+            throw rangeError("bad cell in addCage");
+        int cell = (i - 1) * BoardSize + (j - 1);
+        if (cageOf[cell] >= 0 || listed[cell])
+            return false;   // Cages do not overlap, nor repeat a cell
+        listed[cell] = true;
+    }
+
+    killerCage cage;
+    cage.sum = sum;
+    cage.size = (int)cells.size();
+    for (size_t k = 0; k < cells.size(); k++)
+        cageOf[(cells[k].first - 1) * BoardSize + (cells[k].second - 1)] = (signed char)cages.size();
+    cages.push_back(cage);
+    setState(state);    // Counts values already on the board
+    return true;
+}
+
+/** @brief Removes every cage
+ * @param None
+ * @return None
+*/
+void board::clearCages()
+{
+    cages.clear();
+    memset(cageOf, -1, sizeof(cageOf));
+}
+
+/** @brief Gets the number of cages
+ * @param None
+ * @return The number of cages added
+*/
+int board::getCageCount() const
+{
+    return (int)cages.size();
+}
+
+/** @brief Empties every cage
+ * @param None
+ * @return None
+*/
+void board::resetCages()
+{
+    for (size_t c = 0; c < cages.size(); c++)
+    {
+        cages[c].placedSum = 0;
+        cages[c].placed = 0;
+        cages[c].used = 0;
+    }
+}
+
+/** @brief Gets the values a cell's cage still allows
+ * @param cell The cell number
+ * @return A mask of the allowed values, AllValues for an uncaged cell
+*/
+unsigned short board::cageMask(int cell) const
+{
+    if (cageOf[cell] < 0)
+        return AllValues;
+    const killerCage &cage = cages[cageOf[cell]];
+    return cageOptions(cage.size - cage.placed, cage.sum - cage.placedSum, AllValues & ~cage.used);
+}
+
+/** @brief Finds the empty cell with the fewest candidates
+ * @param None
+ * @return A pair containing the row and column of the cell, or -1, -1 if none is empty
+*/
+pair<int, int> board::findBestCell()
+{
+    int best = -1, fewest = MaxValue + 1;
+    for (int cell = 0; cell < CellCount && fewest > 1; cell++)
+    {
+        if (state.cells[cell] != Blank)
+            continue;
+        unsigned short cand = cageMask(cell) & ~state.usedMask(cell);
+        int count = 0;
+        for (; cand; cand &= cand - 1)
+            count++;
+        if (count < fewest)
+        {
+            fewest = count;
+            best = cell;
+        }
+    }
+    if (best < 0)
+        return make_pair(-1, -1);
+    return make_pair(best / BoardSize + 1, best % BoardSize + 1);
+}
+
 /** @brief Finds an empty cell
  * @param None
  * @return A pair containing the row and column of the empty cell
@@ -274,7 +433,7 @@ pair<int, int> board::findEmptyCell()
 bool board::solveBoard()
 {
     callCount++;    // Increments the call count
-    pair<int, int> cell = findEmptyCell();  // Finds an empty cell
+    pair<int, int> cell = cages.empty() ? findEmptyCell() : findBestCell();  // Cages make the order matter
 
     if (cell.first == -1 && cell.second == -1)
     {
@@ -283,10 +442,13 @@ bool board::solveBoard()
 
     int i = cell.first;
     int j = cell.second;
+    unsigned short used = state.usedMask((i - 1) * BoardSize + (j - 1));  // Values already in the row, column or square
+    if (!cages.empty())
+        used |= AllValues & ~cageMask((i - 1) * BoardSize + (j - 1));   // Values no cage sum allows
 
     for (int num = MinValue; num <= MaxValue; num++)
     {
-        if (conflicts[i][j][num] == 0)  // If there are no conflicts, set the cell to the number
+        if (!(used & (1 << (num - MinValue))))  // If there are no conflicts, set the cell to the number
         {
             setCell(i, j, num);
 
@@ -302,46 +464,199 @@ bool board::solveBoard()
     return false;   // Returns false if the board is not solved
 }
 
-int main()
+/** @brief Gets the SAT variable for a cell holding a value
+ * @param i The row of the cell
+ * @param j The column of the cell
+ * @param val The value in the cell
+ * @return The variable number
+*/
+int satVar(int i, int j, int val)
 {
-    ifstream fin("sudoku.txt");   // Opens the file
-    if (!fin)
-    {
-        cerr << "Cannot open sudoku.txt" << endl;   // Prints an error if the file cannot be opened
-        exit(1);    // Exits the program
-    }
+    return ((i - 1) * BoardSize + (j - 1)) * MaxValue + (val - MinValue);
+}
 
-    try
-    {
-        board b1(SquareSize);   // Creates a board
-        while (fin && fin.peek() != 'Z')    // While the file is not empty and the ending character isn't encountered
+/** @brief Adds at-least-one and pairwise at-most-one clauses for a unit
+ * @param solver The solver to add to
+ * @param vars The variables of which exactly one must be true
+ * @return None
+*/
+void addExactlyOne(satSolver &solver, const vector<int> &vars)
+{
+    vector<int> clause;
+    for (size_t a = 0; a < vars.size(); a++)
+        clause.push_back(satSolver::makeLit(vars[a], false));
+    solver.addClause(clause);   // At least one
+
+    for (size_t a = 0; a < vars.size(); a++)
+        for (size_t b = a + 1; b < vars.size(); b++)
         {
-            b1.initialize(fin); // Initializes the board
-            b1.print(); // Prints the board
-            b1.solveBoard();    // Solves the board
-            if (b1.isSolved())  // If the board is solved, print the board and the number of recursive calls
-            {
-                b1.print();
-                cout << "Sudoku board is solved!" << endl;
-                cout << "Number of recursive calls: " << callCount << endl;
-                totalSolved++;  // Increments the total number of solved boards
-                totalCallCount += callCount;    // Increments the total call count
-                callCount = 0;
-            }
-            else    // If the board is not solved, print an error message
-            {
-                cout << "Sudoku board is not solved." << endl;
-            }
+            clause.clear();
+            clause.push_back(satSolver::makeLit(vars[a], true));
+            clause.push_back(satSolver::makeLit(vars[b], true));
+            solver.addClause(clause);   // At most one
+        }
+}
+
+/** @brief Adds the cell, row, column and square constraints of a board
+ * @param solver The solver to add to
+ * @return None
+*/
+void addBoardConstraints(satSolver &solver)
+{
+    vector<int> vars;
+
+    for (int i = 1; i <= BoardSize; i++)
+        for (int j = 1; j <= BoardSize; j++)
+        {
+            vars.clear();
+            for (int k = MinValue; k <= MaxValue; k++)
+                vars.push_back(satVar(i, j, k));
+            addExactlyOne(solver, vars);    // One value per cell
         }
+
+    for (int k = MinValue; k <= MaxValue; k++)
+        for (int n = 1; n <= BoardSize; n++)
+        {
+            vars.clear();
+            for (int m = 1; m <= BoardSize; m++)
+                vars.push_back(satVar(n, m, k));
+            addExactlyOne(solver, vars);    // Once per row
+
+            vars.clear();
+            for (int m = 1; m <= BoardSize; m++)
+                vars.push_back(satVar(m, n, k));
+            addExactlyOne(solver, vars);    // Once per column
+
+            vars.clear();
+            int rowStart = SquareSize * ((n - 1) / SquareSize) + 1;
+            int colStart = SquareSize * ((n - 1) % SquareSize) + 1;
+            for (int row = rowStart; row < rowStart + SquareSize; row++)
+                for (int col = colStart; col < colStart + SquareSize; col++)
+                    vars.push_back(satVar(row, col, k));
+            addExactlyOne(solver, vars);    // Once per square
+        }
+}
+
+/** @brief Gets this thread's SAT solver, encoding the constraints on first use
+ * @param None
+ * @return A solver holding the board constraints
+*/
+satSolver &threadSolver()
+{
+    static thread_local satSolver solver(CellCount * MaxValue);
+    static thread_local bool encoded = false;
+    if (!encoded)
+    {
+        addBoardConstraints(solver);
+        encoded = true;
     }
-    catch (indexRangeError &ex)
+    return solver;
+}
+
+/** @brief Gets this thread's band solver
+ * @param None
+ * @return The solver
+*/
+bandSolver &threadBandSolver()
+{
+    static thread_local bandSolver solver;
+    return solver;
+}
+
+/** @brief Does the per-thread setup of an engine ahead of solving
+ * @param engine The engine that will be used on this thread
+ * @return None
+ * @note After this, solving with the engine performs no heap allocation
+*/
+void board::prepare(engineType engine)
+{
+    if (engine == SatEngine)
     {
-        cout << ex.what() << endl;  // Prints an error message
-        exit(1);    // Exits the program
+        board warmUp(SquareSize);
+        warmUp.solveSAT();  // Encodes the constraints and sizes the work lists
     }
+}
+
+/** @brief Solves the board with the built-in CDCL SAT engine
+ * @param None
+ * @return True if the board is solved, false otherwise
+ * @note Each decision made by the SAT solver is counted as a call
+*/
+bool board::solveSAT()
+{
+    satSolver &solver = threadSolver();
+    solver.reset(); // Drops everything learnt from the previous board
+
+    bool consistent = true;
+    for (int cell = 0; cell < CellCount; cell++)
+        if (state.cells[cell] != Blank)   // Givens are unit clauses
+            consistent &= solver.addUnit(satSolver::makeLit(cell * MaxValue + state.cells[cell] - MinValue, false));
+
+    bool sat = consistent && solver.solve();
+    callCount += solver.getDecisions() + 1;
+    if (!sat)
+        return false;
 
-    cout << "Total number of recursive calls: " << totalCallCount << endl; // Prints the total number of recursive calls
-    cout << "Average number of recursive calls: " << totalCallCount / totalSolved << endl;   // Prints the average number of recursive calls
+    for (int i = 1; i <= BoardSize; i++)
+        for (int j = 1; j <= BoardSize; j++)
+            if (isBlank(i, j))
+                for (int k = MinValue; k <= MaxValue; k++)
+                    if (solver.modelValue(satVar(i, j, k)))
+                        setCell(i, j, k);   // Decodes the model into the board
 
-    return 0;
-}
\ No newline at end of file
+    return true;
+}
+
+/** @brief Solves the board with the table-driven band engine
+ * @param None
+ * @return True if the board is solved, false otherwise
+ * @note Each call of the band search is counted as a call
+*/
+bool board::solveBands()
+{
+    bandSolver &solver = threadBandSolver();
+    bool solved = solver.solve(state);
+    callCount += solver.getNodes();
+    return solved;
+}
+
+/** @brief Gets the name of an engine
+ * @param engine The engine
+ * @return The name used on the command line
+*/
+const char *engineName(engineType engine)
+{
+    return engine == SatEngine ? "sat" : engine == BandEngine ? "band" : "backtrack";
+}
+
+/** @brief Looks up an engine by name
+ * @param name The name used on the command line
+ * @param engine Set to the engine if the name is known
+ * @return True if the name is known, false otherwise
+*/
+bool parseEngine(const char *name, engineType &engine)
+{
+    if (strcmp(name, "sat") == 0)
+        engine = SatEngine;
+    else if (strcmp(name, "backtrack") == 0)
+        engine = BacktrackEngine;
+    else if (strcmp(name, "band") == 0)
+        engine = BandEngine;
+    else
+        return false;
+    return true;
+}
+
+/** @brief Solves the board with the selected engine
+ * @param engine The engine to use
+ * @return True if the board is solved, false otherwise
+ * @note A board with cages is always solved by backtracking
+*/
+bool board::solve(engineType engine)
+{
+    if (engine == SatEngine && cages.empty())   // Neither encoding has sums
+        return solveSAT();
+    if (engine == BandEngine && cages.empty())
+        return solveBands();
+    return solveBoard();
+}
@@ -0,0 +1,197 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef BOARD_CLASS
+#define BOARD_CLASS
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include "d_except.h"
+#include <fstream>
+using namespace std;
+
+typedef int ValueType;
+const int Blank = -1;
+const int SquareSize = 3;
+const int BoardSize = SquareSize * SquareSize;
+const int MinValue = 1;
+const int MaxValue = 9;
+const int CellCount = BoardSize * BoardSize;
+const int CacheLine = 64;  // Bytes in a cache line, for padding data different threads write
+
+enum engineType { BacktrackEngine, SatEngine, BandEngine };  // Search engines selectable from main
+
+const char *engineName(engineType engine);
+bool parseEngine(const char *name, engineType &engine);
+
+class satSolver;
+
+int satVar(int i, int j, int val);
+// SAT variable that is true when cell (i, j) holds val
+
+satSolver &threadSolver();
+// this thread's solver, holding the board constraints and no clues
+
+class bandSolver;
+
+bandSolver &threadBandSolver();
+// this thread's band solver, holding the statistics of its last solve
+
+// Fixed-size, trivially copyable contents of a board. A snapshot is a few
+// hundred bytes, so it can be copied with memcpy, kept in arenas and reset
+// without touching the heap. Cells are numbered 0 to CellCount - 1 row by
+// row, and bit val - MinValue of a mask stands for val.
+struct boardState
+{
+    signed char cells[CellCount];   // Value of each cell, or Blank
+    unsigned char filled;           // Number of non-blank cells
+    unsigned char rowCount[BoardSize][MaxValue];    // Copies of each value per row
+    unsigned char colCount[BoardSize][MaxValue];    // Copies of each value per column
+    unsigned char boxCount[BoardSize][MaxValue];    // Copies of each value per square
+    unsigned short rowMask[BoardSize];  // Values present in each row
+    unsigned short colMask[BoardSize];  // Values present in each column
+    unsigned short boxMask[BoardSize];  // Values present in each square
+
+    void clear();
+    void place(int cell, int val);
+    void remove(int cell);
+    unsigned short usedMask(int cell) const;
+    int conflictCount(int cell, int val) const;
+};
+
+const unsigned short AllValues = (1 << MaxValue) - 1;
+
+/** @brief Gets the square containing a cell
+ * @param cell The cell number
+ * @return The square number
+*/
+inline int boxOf(int cell)
+{
+    return SquareSize * (cell / BoardSize / SquareSize) + (cell % BoardSize) / SquareSize;
+}
+
+/** @brief Empties the snapshot
+ * @param None
+ * @return None
+*/
+inline void boardState::clear()
+{
+    memset(this, 0, sizeof(boardState));
+    memset(cells, Blank, sizeof(cells));    // Sets all cells to blank
+}
+
+/** @brief Writes a value into a blank cell and counts it in its units
+ * @param cell The cell number
+ * @param val The value to write
+ * @return None
+*/
+inline void boardState::place(int cell, int val)
+{
+    int r = cell / BoardSize, c = cell % BoardSize, b = boxOf(cell), v = val - MinValue;
+    cells[cell] = (signed char)val;
+    filled++;
+    if (rowCount[r][v]++ == 0)
+        rowMask[r] |= 1 << v;
+    if (colCount[c][v]++ == 0)
+        colMask[c] |= 1 << v;
+    if (boxCount[b][v]++ == 0)
+        boxMask[b] |= 1 << v;
+}
+
+/** @brief Blanks a filled cell and uncounts its value
+ * @param cell The cell number
+ * @return None
+*/
+inline void boardState::remove(int cell)
+{
+    int r = cell / BoardSize, c = cell % BoardSize, b = boxOf(cell), v = cells[cell] - MinValue;
+    cells[cell] = Blank;
+    filled--;
+    if (--rowCount[r][v] == 0)
+        rowMask[r] &= ~(1 << v);
+    if (--colCount[c][v] == 0)
+        colMask[c] &= ~(1 << v);
+    if (--boxCount[b][v] == 0)
+        boxMask[b] &= ~(1 << v);
+}
+
+/** @brief Gets the values already used by the units of a cell
+ * @param cell The cell number
+ * @return A mask of the conflicting values
+*/
+inline unsigned short boardState::usedMask(int cell) const
+{
+    return rowMask[cell / BoardSize] | colMask[cell % BoardSize] | boxMask[boxOf(cell)];
+}
+
+/** @brief Counts the copies of a value in the units of a cell
+ * @param cell The cell number
+ * @param val The value
+ * @return The number of conflicts, 0 if val can be placed
+*/
+inline int boardState::conflictCount(int cell, int val) const
+{
+    int v = val - MinValue;
+    return rowCount[cell / BoardSize][v] + colCount[cell % BoardSize][v] + boxCount[boxOf(cell)][v];
+}
+
+const int MaxCageSum = MaxValue * (MaxValue + 1) / 2;
+
+// A killer cage: its cells hold different values adding up to sum
+struct killerCage
+{
+    int sum;            // Target sum
+    int size;           // Number of cells
+    int placedSum;      // Sum of the values placed so far
+    int placed;         // Cells filled so far
+    unsigned short used;    // Values placed so far
+};
+
+unsigned short cageOptions(int cells, int sum, unsigned short available);
+// values that appear in some set of cells distinct values from available
+// adding up to sum, read from a table built once
+
+class board
+{
+public:
+    board(int);
+    void clear();
+    void initialize(ifstream &fin);
+    void initialize(const char *cells);
+    void print(ostream &out = cout);
+    void printConflicts();
+    bool isBlank(int, int);
+    ValueType getCell(int, int);
+    void setCell(int, int, int);
+    void clearCell(int, int);
+    bool isSolved();
+    pair<int, int> findEmptyCell();
+    bool solveBoard();
+    bool solveSAT();
+    bool solveBands();
+    bool solve(engineType);
+    static void prepare(engineType);
+    int getCallCount() const;
+    void resetCallCount();
+    const boardState &getState() const;
+    void setState(const boardState &);
+    bool addCage(int sum, const vector<pair<int, int> > &cells);
+    void clearCages();
+    int getCageCount() const;
+    unsigned short cageMask(int cell) const;
+
+private:
+    int callCount;  // Recursive calls since the last reset
+    boardState state;
+    vector<killerCage> cages;
+    signed char cageOf[CellCount];  // Cage of each cell, or -1
+
+    pair<int, int> findBestCell();
+    void resetCages();
+
+    void updateConflicts(int, int, int, int);
+    void undoChanges(int, int, int, int);
+};
+
+#endif  // BOARD_CLASS
@@ -0,0 +1,179 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include "checkpoint.h"
+using namespace std;
+
+const char CheckpointMagic[] = "SDKCKPT2";
+
+/** @brief Gets the time on the steady clock
+ * @param None
+ * @return Seconds since an arbitrary start
+*/
+double steadySeconds()
+{
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** @brief Zeroes the totals
+ * @param None
+ * @return None
+*/
+void runStats::clear()
+{
+    puzzles = calls = solved = allocations = 0;
+    counters.clear();
+}
+
+/** @brief Accumulates other totals into these
+ * @param other The totals to add
+ * @return None
+*/
+void runStats::add(const runStats &other)
+{
+    puzzles += other.puzzles;
+    calls += other.calls;
+    solved += other.solved;
+    allocations += other.allocations;
+    counters.add(other.counters);
+}
+
+/** @brief Writes the totals on one line
+ * @param out The stream to write to
+ * @return None
+*/
+void runStats::write(ostream &out) const
+{
+    out << puzzles << " " << calls << " " << solved << " " << allocations;
+    for (int e = 0; e < PerfEventCount; e++)
+        out << " " << counters.valid[e] << " " << counters.scaled[e] << " " << counters.values[e];
+    out << endl;
+}
+
+/** @brief Reads totals written by write
+ * @param in The stream to read from
+ * @return True if the totals were read, false otherwise
+*/
+bool runStats::read(istream &in)
+{
+    in >> puzzles >> calls >> solved >> allocations;
+    for (int e = 0; e < PerfEventCount; e++)
+        in >> counters.valid[e] >> counters.scaled[e] >> counters.values[e];
+    return (bool)in;
+}
+
+/** @brief Saves a checkpoint atomically
+ * @param path The checkpoint file
+ * @param state The checkpoint
+ * @return True if it was saved, false otherwise
+*/
+bool saveCheckpoint(const string &path, const checkpoint &state)
+{
+    string temp = path + ".tmp";
+    {
+        ofstream fout(temp.c_str());
+        fout << CheckpointMagic << endl << state.input << " " << state.output << endl;
+        state.stats.write(fout);
+        if (!fout)
+            return false;
+    }
+    return rename(temp.c_str(), path.c_str()) == 0;
+}
+
+/** @brief Reads a checkpoint
+ * @param path The checkpoint file
+ * @param state Set to the checkpoint
+ * @return True if a checkpoint was read, false otherwise
+*/
+bool loadCheckpoint(const string &path, checkpoint &state)
+{
+    ifstream fin(path.c_str());
+    string magic;
+    if (!(fin >> magic) || magic != CheckpointMagic)
+        return false;
+    fin >> state.input >> state.output;
+    return state.stats.read(fin);
+}
+
+/** @brief Constructor for checkpointWriter class
+ * @param path The checkpoint file
+ * @return None
+*/
+checkpointWriter::checkpointWriter(const string &path) : file(path), hasPending(false), stopping(false),
+                                                         failure(false), lastSubmit(steadySeconds())
+{
+    saver = thread(&checkpointWriter::run, this);
+}
+
+/** @brief Destructor for checkpointWriter class
+ * @param None
+ * @return None
+*/
+checkpointWriter::~checkpointWriter()
+{
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    saver.join();
+}
+
+/** @brief Checks whether the next checkpoint is due
+ * @param None
+ * @return True if the interval has passed
+*/
+bool checkpointWriter::due() const
+{
+    lock_guard<mutex> guard(lock);
+    return steadySeconds() - lastSubmit >= CheckpointSeconds;
+}
+
+/** @brief Hands a checkpoint to the saver thread
+ * @param state The checkpoint
+ * @return None
+*/
+void checkpointWriter::submit(const checkpoint &state)
+{
+    {
+        lock_guard<mutex> guard(lock);
+        pending = state;
+        hasPending = true;
+        lastSubmit = steadySeconds();
+    }
+    wake.notify_one();
+}
+
+/** @brief Checks for a failed save
+ * @param None
+ * @return True if a checkpoint could not be saved
+*/
+bool checkpointWriter::failed() const
+{
+    lock_guard<mutex> guard(lock);
+    return failure;
+}
+
+/** @brief Saves checkpoints as they arrive
+ * @param None
+ * @return None
+*/
+void checkpointWriter::run()
+{
+    unique_lock<mutex> guard(lock);
+    while (true)
+    {
+        wake.wait(guard, [this]() { return hasPending || stopping; });
+        if (!hasPending)
+            return; // Stopping with nothing left to save
+        checkpoint state = pending;
+        hasPending = false;
+        guard.unlock();
+        bool ok = saveCheckpoint(file, state);  // Slow part, outside the lock
+        guard.lock();
+        failure |= !ok;
+    }
+}
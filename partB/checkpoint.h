@@ -0,0 +1,82 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef RUN_CHECKPOINT
+#define RUN_CHECKPOINT
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "perfcount.h"
+using namespace std;
+
+const double CheckpointSeconds = 5.0;   // Time between checkpoints of a run
+
+// Totals accumulated over a batch run
+struct runStats
+{
+    long puzzles;       // Puzzles read
+    long calls;         // Recursive calls over the solved boards
+    long solved;        // Boards solved
+    long allocations;   // Heap allocations made while solving
+    perfSample counters;
+
+    void clear();
+    void add(const runStats &other);
+    void write(ostream &out) const;
+    bool read(istream &in);
+};
+
+// Where a run can pick up again: every result before the output offset
+// has been written, and it covers the input up to the input position
+struct checkpoint
+{
+    long input;     // puzzleSource::position() after the last written result
+    long output;    // Byte offset in the output file
+    runStats stats;
+};
+
+bool saveCheckpoint(const string &path, const checkpoint &state);
+// writes the checkpoint to a new file and renames it over path, so a
+// reader sees either the old checkpoint or the new one
+
+bool loadCheckpoint(const string &path, checkpoint &state);
+
+// Saves checkpoints on a thread of its own. The thread that produces
+// results only copies a checkpoint in, so file writes never hold it up.
+// Checkpoints that arrive while one is being saved replace each other,
+// and the newest is saved next.
+class checkpointWriter
+{
+public:
+    checkpointWriter(const string &path);
+    ~checkpointWriter();
+    // saves the last submitted checkpoint and stops the thread
+
+    bool due() const;
+    // true once CheckpointSeconds have passed since the last submit
+
+    void submit(const checkpoint &state);
+
+    bool failed() const;
+    // true if a save has failed
+
+private:
+    string file;
+    mutable mutex lock;
+    condition_variable wake;
+    checkpoint pending;
+    bool hasPending;
+    bool stopping;
+    bool failure;
+    double lastSubmit;  // Seconds on the steady clock
+    thread saver;
+
+    void run();
+
+    checkpointWriter(const checkpointWriter &);
+    checkpointWriter &operator=(const checkpointWriter &);
+};
+
+#endif  // RUN_CHECKPOINT
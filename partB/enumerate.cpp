@@ -0,0 +1,194 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <atomic>
+#include <thread>
+#include "enumerate.h"
+#include "logic.h"
+using namespace std;
+
+/** @brief Constructor for solutionEnumerator class
+ * @param None
+ * @return None
+*/
+solutionEnumerator::solutionEnumerator() : top(0), descend(false), finished(true), part(0), parts(1),
+                                           splitLevel(DefaultSplitLevel), splitCount(0), nodes(0)
+{
+    state.clear();
+}
+
+/** @brief Begins a walk over the solutions of a puzzle
+ * @param puzzle The grid to complete
+ * @param part The part to walk, 0 to parts - 1
+ * @param parts The number of parts the walk is split into
+ * @param splitLevel The level whose branches are dealt out to the parts
+ * @return None
+*/
+void solutionEnumerator::start(const boardState &puzzle, int part, int parts, int splitLevel)
+{
+    state = puzzle;
+    top = 0;
+    descend = true;
+    finished = hasDuplicates(puzzle);   // Clashing givens have no solutions
+    this->part = part;
+    this->parts = parts;
+    this->splitLevel = splitLevel;
+    splitCount = 0;
+    nodes = 0;
+}
+
+/** @brief Finds the next solution
+ * @param cells Set to the solution, BoardSize * BoardSize characters
+ * @return True if a solution was found, false once the walk is over
+*/
+bool solutionEnumerator::next(char *cells)
+{
+    while (!finished)
+    {
+        if (descend)
+        {
+            descend = false;
+            if (state.filled == CellCount)
+            {
+                if (top <= splitLevel && part != 0)
+                    continue;   // Reached without a numbered branch; part 0 reports it
+
+                for (int cell = 0; cell < CellCount; cell++)
+                    cells[cell] = (char)('0' + state.cells[cell]);
+                return true;
+            }
+
+            int best = -1, fewest = MaxValue + 1;
+            unsigned short bestCand = 0;
+            for (int cell = 0; cell < CellCount && fewest > 1; cell++)
+            {
+                if (state.cells[cell] != Blank)
+                    continue;
+                unsigned short cand = AllValues & ~state.usedMask(cell);
+                int count = 0;
+                for (unsigned short rest = cand; rest; rest &= rest - 1)
+                    count++;
+                if (count < fewest)
+                {
+                    fewest = count;
+                    best = cell;
+                    bestCand = cand;
+                }
+            }
+            if (fewest == 0)
+                continue;   // Dead end: some cell has no value left
+
+            frames[top].cell = (signed char)best;
+            frames[top].remaining = bestCand;
+            top++;
+        }
+
+        if (top == 0)
+        {
+            finished = true;
+            break;
+        }
+
+        frame &f = frames[top - 1];
+        if (state.cells[f.cell] != Blank)
+            state.remove(f.cell);   // Takes back the value tried last
+        if (f.remaining == 0)
+        {
+            top--;  // Every value of this frame has been tried
+            continue;
+        }
+
+        int v = 0;
+        while (!(f.remaining >> v & 1))
+            v++;
+        f.remaining &= ~(1 << v);
+        if (top - 1 == splitLevel && splitCount++ % parts != part)
+            continue;   // The branch belongs to another part
+
+        state.place(f.cell, v + MinValue);
+        nodes++;
+        descend = true;
+    }
+    return false;
+}
+
+/** @brief Gets the number of decisions behind the last solution
+ * @param None
+ * @return The search depth
+*/
+int solutionEnumerator::depth() const
+{
+    return top;
+}
+
+/** @brief Gets a decision behind the last solution
+ * @param level The level, 0 to depth() - 1
+ * @param cell Set to the cell branched on
+ * @param val Set to the value it holds
+ * @return None
+*/
+void solutionEnumerator::choice(int level, int &cell, int &val) const
+{
+    if (level < 0 || level >= top)
+        throw rangeError("bad level in solutionEnumerator::choice");
+    cell = frames[level].cell;
+    val = state.cells[cell];
+}
+
+/** @brief Drops the rest of a subtree of the search
+ * @param level The last level whose decision is kept by the skipped solutions
+ * @return None
+*/
+void solutionEnumerator::skipSubtree(int level)
+{
+    if (level < 0 || level >= top)
+        throw rangeError("bad level in solutionEnumerator::skipSubtree");
+    while (top > level + 1)
+    {
+        top--;
+        if (state.cells[frames[top].cell] != Blank)
+            state.remove(frames[top].cell); // Unwinds the deeper decisions
+    }
+    descend = false;
+}
+
+/** @brief Gets the number of values tried
+ * @param None
+ * @return Nodes visited since start()
+*/
+long solutionEnumerator::getNodes() const
+{
+    return nodes;
+}
+
+/** @brief Counts solutions in parallel
+ * @param puzzle The grid to complete
+ * @param limit Stops after this many solutions, 0 for no limit
+ * @param numThreads The number of enumerator threads
+ * @param splitLevel The level whose branches are dealt out to the threads
+ * @return The number of solutions, at most limit
+*/
+long countSolutions(const boardState &puzzle, long limit, int numThreads, int splitLevel)
+{
+    atomic<long> found(0);
+    numThreads = max(numThreads, 1);
+
+    auto worker = [&](int part)
+    {
+        solutionEnumerator walk;
+        char cells[CellCount];
+        walk.start(puzzle, part, numThreads, splitLevel);
+        while ((limit == 0 || found.load(memory_order_relaxed) < limit) && walk.next(cells))
+            found.fetch_add(1, memory_order_relaxed);
+    };
+
+    vector<thread> workers;
+    for (int t = 1; t < numThreads; t++)
+        workers.push_back(thread(worker, t));
+    worker(0);  // The calling thread walks part 0
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+
+    long total = found;
+    return limit != 0 && total > limit ? limit : total;
+}
@@ -0,0 +1,68 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef SOLUTION_ENUMERATOR
+#define SOLUTION_ENUMERATOR
+
+#include "board.h"
+
+const int DefaultSplitLevel = 3;    // Search level whose branches are dealt out to threads
+
+// Walks every solution of a grid one at a time. The search is an explicit
+// stack of at most CellCount frames held in the object, so it can stop
+// after any solution and resume on the next call, and its memory does not
+// grow with the number of solutions. Each frame branches on the blank cell
+// with the fewest candidates.
+//
+// For parallel walks, the branches taken at the split level are numbered
+// in search order and a part of parts only enters those whose number is
+// part modulo parts. The parts together see every solution exactly once.
+class solutionEnumerator
+{
+public:
+    solutionEnumerator();
+
+    void start(const boardState &puzzle, int part = 0, int parts = 1, int splitLevel = DefaultSplitLevel);
+    // begins a walk over the solutions of puzzle, or over one part of them
+
+    bool next(char *cells);
+    // finds the next solution and writes it as BoardSize * BoardSize
+    // characters. returns false once there are no more
+
+    int depth() const;
+    // number of branching decisions behind the last solution
+
+    void choice(int level, int &cell, int &val) const;
+    // the decision made at a level, 0 to depth() - 1
+
+    void skipSubtree(int level);
+    // drops the remaining solutions that share the decisions up to and
+    // including level with the last one. the next call to next()
+    // continues with the following value at that level
+
+    long getNodes() const;
+    // values tried so far
+
+private:
+    struct frame
+    {
+        signed char cell;           // Cell being branched on
+        unsigned short remaining;   // Values not tried yet
+    };
+
+    boardState state;
+    frame frames[CellCount];
+    int top;            // Frames in use
+    bool descend;       // True to branch below the current state
+    bool finished;
+    int part, parts, splitLevel;
+    long splitCount;    // Branches numbered at the split level
+    long nodes;
+};
+
+long countSolutions(const boardState &puzzle, long limit, int numThreads, int splitLevel = DefaultSplitLevel);
+// counts solutions with numThreads enumerators over disjoint parts,
+// stopping once limit have been found (0 for no limit). returns the
+// count, at most limit
+
+#endif  // SOLUTION_ENUMERATOR
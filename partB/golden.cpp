@@ -0,0 +1,138 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <sstream>
+#include <string>
+#include "band.h"
+#include "golden.h"
+#include "sat.h"
+using namespace std;
+
+/** @brief Solves a puzzle and records the work done
+ * @param cells The puzzle, BoardSize * BoardSize characters row by row
+ * @param engine The engine to solve with
+ * @param record Set to the solution and counts; the puzzle number is left alone
+ * @return True if the puzzle was solved, false otherwise
+*/
+bool measureSearch(const char *cells, engineType engine, goldenRecord &record)
+{
+    board b(SquareSize);
+    b.initialize(cells);
+    int given = b.getState().filled;
+    bool solved = b.solve(engine);
+    const boardState &state = b.getState();
+
+    record.engine = engine;
+    record.counts.nodes = b.getCallCount();
+    if (engine == SatEngine)
+    {
+        const satSolver &solver = threadSolver();   // Still holds the statistics of this solve
+        record.counts.backtracks = solver.getConflicts();
+        record.counts.propagations = solver.getPropagations();
+    }
+    else if (engine == BandEngine)
+    {
+        const bandSolver &solver = threadBandSolver();
+        record.counts.backtracks = solver.getBacktracks();
+        record.counts.propagations = solver.getForced();
+    }
+    else
+    {
+        // Every call but the first follows a placement, and the placements
+        // that were not taken back are the cells filled in the end
+        record.counts.backtracks = record.counts.nodes - 1 - (state.filled - given);
+        record.counts.propagations = 0;
+    }
+    for (int cell = 0; cell < CellCount; cell++)
+        record.solution[cell] = state.cells[cell] == Blank ? '.' : (char)('0' + state.cells[cell]);
+    return solved;
+}
+
+/** @brief Writes a record as one line
+ * @param out The stream to write to
+ * @param record The record
+ * @return None
+*/
+void writeGolden(ostream &out, const goldenRecord &record)
+{
+    out << record.puzzle << " " << engineName(record.engine) << " " << record.counts.nodes << " "
+        << record.counts.backtracks << " " << record.counts.propagations << " ";
+    out.write(record.solution, CellCount);
+    out << endl;
+}
+
+/** @brief Reads the next record of a golden file
+ * @param in The stream to read from
+ * @param record Set to the record
+ * @return True if a record was read, false otherwise
+*/
+bool readGolden(istream &in, goldenRecord &record)
+{
+    string line;
+    while (getline(in, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+        istringstream fields(line);
+        string engine, solution;
+        fields >> record.puzzle >> engine >> record.counts.nodes >> record.counts.backtracks
+               >> record.counts.propagations >> solution;
+        if (!fields || !parseEngine(engine.c_str(), record.engine) || solution.size() != (size_t)CellCount)
+            return false;
+        memcpy(record.solution, solution.data(), CellCount);
+        return true;
+    }
+    return false;
+}
+
+/** @brief Compares one count with its golden value
+ * @param name The name of the count
+ * @param expected The golden value
+ * @param actual The value measured now
+ * @param tolerance The growth allowed, in percent
+ * @param prefix Printed before a line about the count
+ * @param out The stream to print to
+ * @return True if the count is within tolerance, false otherwise
+*/
+bool compareCount(const char *name, long expected, long actual, double tolerance, const string &prefix,
+                  ostream &out)
+{
+    if (actual == expected)
+        return true;
+    bool pass = actual < expected || actual <= expected * (1 + tolerance / 100);
+    out << prefix << name << " " << expected << " -> " << actual;
+    if (expected > 0)
+        out << " (" << (actual > expected ? "+" : "") << 100.0 * (actual - expected) / expected << "%)";
+    out << (pass ? "" : " FAIL") << endl;
+    return pass;
+}
+
+/** @brief Compares a measured record with its golden record
+ * @param expected The golden record
+ * @param actual The record measured now
+ * @param tolerance The growth allowed in any count, in percent
+ * @param out The stream to print the differences to
+ * @return True if the record passes, false otherwise
+*/
+bool compareGolden(const goldenRecord &expected, const goldenRecord &actual, double tolerance, ostream &out)
+{
+    ostringstream label;
+    label << "Puzzle " << expected.puzzle << " " << engineName(expected.engine) << ": ";
+    string prefix = label.str();
+
+    bool pass = true;
+    if (memcmp(expected.solution, actual.solution, CellCount) != 0)
+    {
+        out << prefix << "solution ";
+        out.write(expected.solution, CellCount);
+        out << " -> ";
+        out.write(actual.solution, CellCount);
+        out << " FAIL" << endl;
+        pass = false;
+    }
+    pass &= compareCount("nodes", expected.counts.nodes, actual.counts.nodes, tolerance, prefix, out);
+    pass &= compareCount("backtracks", expected.counts.backtracks, actual.counts.backtracks, tolerance, prefix, out);
+    pass &= compareCount("propagations", expected.counts.propagations, actual.counts.propagations, tolerance,
+                         prefix, out);
+    return pass;
+}
@@ -0,0 +1,50 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef GOLDEN_COUNTS
+#define GOLDEN_COUNTS
+
+#include <iostream>
+#include "board.h"
+using namespace std;
+
+// Golden search counts. The engines are deterministic, so the work they
+// do on a puzzle is the same on every run and every machine. A golden file
+// records it per puzzle and engine, and a later run that does more work
+// than recorded points at a change in the search, whatever the load.
+
+const int EngineCount = 3;  // Engines recorded for every puzzle
+
+// Work done solving one puzzle with one engine
+struct searchCounts
+{
+    long nodes;         // Recursive calls (backtracking, band) or decisions + 1 (SAT)
+    long backtracks;    // Values or placements taken back, or conflicts (SAT)
+    long propagations;  // Literals propagated (SAT), forced placements (band), 0 for backtracking
+};
+
+// One line of a golden file
+struct goldenRecord
+{
+    long puzzle;                // Position in the puzzle file
+    engineType engine;
+    char solution[CellCount];   // '.' for cells left blank
+    searchCounts counts;
+};
+
+bool measureSearch(const char *cells, engineType engine, goldenRecord &record);
+// solves a puzzle on this thread and fills in the solution and counts of
+// record. returns true if the puzzle was solved
+
+void writeGolden(ostream &out, const goldenRecord &record);
+
+bool readGolden(istream &in, goldenRecord &record);
+// reads the next record, skipping blank lines and lines starting with '#'.
+// returns false at the end of the file or on a malformed line
+
+bool compareGolden(const goldenRecord &expected, const goldenRecord &actual, double tolerance, ostream &out);
+// prints a line for every count that changed and for a changed solution.
+// returns false if the solution changed or a count grew by more than
+// tolerance percent; counts that shrink are reported but pass
+
+#endif  // GOLDEN_COUNTS
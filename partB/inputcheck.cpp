@@ -0,0 +1,129 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include "inputcheck.h"
+using namespace std;
+
+/** @brief Gets the name of a problem
+ * @param problem The problem
+ * @return A short name for reports
+*/
+const char *inputProblemName(inputProblem problem)
+{
+    switch (problem)
+    {
+    case BadLength:
+        return "bad-length";
+    case UnknownCharacter:
+        return "unknown-character";
+    case DuplicateClue:
+        return "duplicate-clue";
+    default:
+        return "no-candidates";
+    }
+}
+
+/** @brief Adds a problem to a report
+ * @param report The report
+ * @param problem The problem
+ * @param cell The cell, or -1
+ * @param value The length, character or clue
+ * @param other The other clue of a duplicate, or -1
+ * @return None
+*/
+inline void addIssue(inputReport &report, inputProblem problem, int cell, int value, int other)
+{
+    inputIssue &issue = report.issues[report.count++];
+    issue.problem = problem;
+    issue.cell = cell;
+    issue.value = value;
+    issue.other = other;
+}
+
+/** @brief Checks a puzzle record
+ * @param cells The record
+ * @param length The number of characters in the record
+ * @param report Set to every problem found
+ * @return True if the record is a well-formed puzzle with no visible contradiction
+*/
+bool checkPuzzle(const char *cells, int length, inputReport &report)
+{
+    report.count = 0;
+    if (length != CellCount)
+    {
+        addIssue(report, BadLength, -1, length, -1);
+        return false;
+    }
+
+    signed char rowFirst[BoardSize][MaxValue], colFirst[BoardSize][MaxValue], boxFirst[BoardSize][MaxValue];
+    memset(rowFirst, -1, sizeof(rowFirst));   // First clue of each value in each unit
+    memset(colFirst, -1, sizeof(colFirst));
+    memset(boxFirst, -1, sizeof(boxFirst));
+    unsigned short rowMask[BoardSize] = {0}, colMask[BoardSize] = {0}, boxMask[BoardSize] = {0};
+
+    for (int cell = 0; cell < CellCount; cell++)
+    {
+        char ch = cells[cell];
+        if (ch == '.')
+            continue;
+        if (ch < '1' || ch > '9')
+        {
+            addIssue(report, UnknownCharacter, cell, (unsigned char)ch, -1);
+            continue;
+        }
+
+        int r = cell / BoardSize, c = cell % BoardSize, b = boxOf(cell), v = ch - '1';
+        int other = rowFirst[r][v] >= 0 ? rowFirst[r][v] : colFirst[c][v] >= 0 ? colFirst[c][v] : boxFirst[b][v];
+        if (other >= 0)
+            addIssue(report, DuplicateClue, cell, v + MinValue, other);
+        if (rowFirst[r][v] < 0)
+            rowFirst[r][v] = (signed char)cell;
+        if (colFirst[c][v] < 0)
+            colFirst[c][v] = (signed char)cell;
+        if (boxFirst[b][v] < 0)
+            boxFirst[b][v] = (signed char)cell;
+        rowMask[r] |= 1 << v;
+        colMask[c] |= 1 << v;
+        boxMask[b] |= 1 << v;
+    }
+
+    for (int cell = 0; cell < CellCount; cell++)
+        if (cells[cell] == '.'
+            && (rowMask[cell / BoardSize] | colMask[cell % BoardSize] | boxMask[boxOf(cell)]) == AllValues)
+            addIssue(report, NoCandidates, cell, 0, -1);
+
+    return report.count == 0;
+}
+
+/** @brief Prints the problems with a record
+ * @param out The stream to print to
+ * @param puzzle The record's position in the input
+ * @param report The problems
+ * @return None
+*/
+void printIssues(ostream &out, long puzzle, const inputReport &report)
+{
+    for (int k = 0; k < report.count; k++)
+    {
+        const inputIssue &issue = report.issues[k];
+        out << "input-error puzzle=" << puzzle << " reason=" << inputProblemName(issue.problem);
+        if (issue.cell >= 0)
+            out << " row=" << issue.cell / BoardSize + 1 << " col=" << issue.cell % BoardSize + 1;
+        switch (issue.problem)
+        {
+        case BadLength:
+            out << " length=" << issue.value;
+            break;
+        case UnknownCharacter:
+            out << " char=" << issue.value;
+            break;
+        case DuplicateClue:
+            out << " value=" << issue.value << " other-row=" << issue.other / BoardSize + 1
+                << " other-col=" << issue.other % BoardSize + 1;
+            break;
+        default:
+            break;
+        }
+        out << endl;
+    }
+}
@@ -0,0 +1,49 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef INPUT_CHECK
+#define INPUT_CHECK
+
+#include <iostream>
+#include "board.h"
+using namespace std;
+
+// Checks a puzzle record before any search is spent on it. Everything is
+// found in one pass over the record, so a bad submission costs as much as
+// reading it instead of a search that proves it has no solution.
+
+enum inputProblem { BadLength, UnknownCharacter, DuplicateClue, NoCandidates };
+
+const char *inputProblemName(inputProblem problem);
+
+const int MaxInputIssues = CellCount + 1;   // One per cell, or one for the length
+
+// One problem with a record
+struct inputIssue
+{
+    inputProblem problem;
+    int cell;   // Cell the problem is at, -1 for BadLength
+    int value;  // The record length, the character code or the clue
+    int other;  // DuplicateClue: an earlier clue of the same value in a shared unit
+};
+
+struct inputReport
+{
+    int count;
+    inputIssue issues[MaxInputIssues];
+};
+
+bool checkPuzzle(const char *cells, int length, inputReport &report);
+// checks a record of length characters, which should be CellCount. reports
+// a wrong length on its own; otherwise reports characters other than '1'
+// to '9' and '.', clues that repeat a value in a row, column or square,
+// and blank cells whose row, column and square already hold every value.
+// returns true if there is no problem
+
+void printIssues(ostream &out, long puzzle, const inputReport &report);
+// prints one line per problem as space-separated key=value fields:
+// input-error puzzle=P reason=R, then row= col= for a cell, then length=,
+// char=, or value= with other-row= other-col= for a duplicate. rows and
+// columns count from 1, puzzles from 0
+
+#endif  // INPUT_CHECK
@@ -0,0 +1,222 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include "logic.h"
+using namespace std;
+
+// Cell lists of every unit, built once
+struct unitTable
+{
+    int cells[UnitCount][BoardSize];
+
+    unitTable()
+    {
+        for (int n = 0; n < BoardSize; n++)
+            for (int k = 0; k < BoardSize; k++)
+            {
+                cells[n][k] = n * BoardSize + k;    // Row n
+                cells[BoardSize + n][k] = k * BoardSize + n;    // Column n
+                int row = SquareSize * (n / SquareSize) + k / SquareSize;
+                int col = SquareSize * (n % SquareSize) + k % SquareSize;
+                cells[2 * BoardSize + n][k] = row * BoardSize + col;    // Square n
+            }
+    }
+};
+
+const unitTable units;
+const int (&unitCells)[UnitCount][BoardSize] = units.cells;
+
+/** @brief Gets the name of a grade
+ * @param grade The grade
+ * @return A short name for reports
+*/
+const char *gradeName(gradeType grade)
+{
+    switch (grade)
+    {
+    case NakedSinglesGrade:
+        return "naked-singles";
+    case HiddenSinglesGrade:
+        return "hidden-singles";
+    case SearchGrade:
+        return "search";
+    default:
+        return "invalid";
+    }
+}
+
+/** @brief Checks for a value given twice in a unit
+ * @param state The board contents
+ * @return True if any unit holds a value more than once
+*/
+bool hasDuplicates(const boardState &state)
+{
+    for (int n = 0; n < BoardSize; n++)
+        for (int v = 0; v < MaxValue; v++)
+            if (state.rowCount[n][v] > 1 || state.colCount[n][v] > 1 || state.boxCount[n][v] > 1)
+                return true;
+    return false;
+}
+
+/** @brief Places every value forced by singles
+ * @param state The board contents, updated in place
+ * @param hidden True to also look for hidden singles
+ * @return The number of cells placed, or -1 on a contradiction
+*/
+int propagateSingles(boardState &state, bool hidden)
+{
+    int placed = 0;
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (int cell = 0; cell < CellCount; cell++)
+        {
+            if (state.cells[cell] != Blank)
+                continue;
+            unsigned short cand = AllValues & ~state.usedMask(cell);
+            if (cand == 0)
+                return -1;  // No value fits
+            if ((cand & (cand - 1)) == 0)   // Naked single
+            {
+                int v = 0;
+                while (!(cand >> v & 1))
+                    v++;
+                state.place(cell, v + MinValue);
+                placed++;
+                changed = true;
+            }
+        }
+
+        if (!hidden || changed)
+            continue;   // Hidden singles only once the cheap rule is stuck
+
+        for (int u = 0; u < UnitCount && !changed; u++)
+        {
+            unsigned short present = 0, once = 0, twice = 0;
+            for (int k = 0; k < BoardSize; k++)
+            {
+                int cell = unitCells[u][k];
+                if (state.cells[cell] != Blank)
+                {
+                    present |= 1 << (state.cells[cell] - MinValue);
+                    continue;
+                }
+                unsigned short cand = AllValues & ~state.usedMask(cell);
+                twice |= once & cand;
+                once |= cand;
+            }
+            if ((present | once) != AllValues)
+                return -1;  // Some value has no place left in the unit
+
+            unsigned short single = once & ~twice & ~present;
+            for (int k = 0; k < BoardSize && single; k++)
+            {
+                int cell = unitCells[u][k];
+                if (state.cells[cell] != Blank)
+                    continue;
+                unsigned short hit = single & ~state.usedMask(cell);
+                if (hit)
+                {
+                    int v = 0;
+                    while (!(hit >> v & 1))
+                        v++;
+                    state.place(cell, v + MinValue);
+                    single &= ~(1 << v);
+                    placed++;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return placed;
+}
+
+/** @brief Finds one value forced by a single
+ * @param state The board contents
+ * @param hidden True to also look for hidden singles
+ * @param cell Set to the cell of the single
+ * @param val Set to the value of the single
+ * @param isHidden Set to true for a hidden single, false for a naked one
+ * @return True if a single was found, false otherwise
+*/
+bool findSingle(const boardState &state, bool hidden, int &cell, int &val, bool &isHidden)
+{
+    for (int c = 0; c < CellCount; c++)
+    {
+        if (state.cells[c] != Blank)
+            continue;
+        unsigned short cand = AllValues & ~state.usedMask(c);
+        if (cand != 0 && (cand & (cand - 1)) == 0)  // Naked single
+        {
+            int v = 0;
+            while (!(cand >> v & 1))
+                v++;
+            cell = c;
+            val = v + MinValue;
+            isHidden = false;
+            return true;
+        }
+    }
+
+    if (!hidden)
+        return false;
+
+    for (int u = 0; u < UnitCount; u++)
+    {
+        unsigned short present = 0, once = 0, twice = 0;
+        for (int k = 0; k < BoardSize; k++)
+        {
+            int c = unitCells[u][k];
+            if (state.cells[c] != Blank)
+            {
+                present |= 1 << (state.cells[c] - MinValue);
+                continue;
+            }
+            unsigned short cand = AllValues & ~state.usedMask(c);
+            twice |= once & cand;
+            once |= cand;
+        }
+
+        unsigned short single = once & ~twice & ~present;
+        for (int k = 0; k < BoardSize && single; k++)
+        {
+            int c = unitCells[u][k];
+            if (state.cells[c] != Blank)
+                continue;
+            unsigned short hit = single & ~state.usedMask(c);
+            if (hit)
+            {
+                int v = 0;
+                while (!(hit >> v & 1))
+                    v++;
+                cell = c;
+                val = v + MinValue;
+                isHidden = true;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/** @brief Grades a puzzle by the rules needed to solve it
+ * @param state The puzzle
+ * @return The simplest sufficient rule set, InvalidGrade if the givens clash
+*/
+gradeType gradePuzzle(const boardState &state)
+{
+    if (hasDuplicates(state))
+        return InvalidGrade;
+
+    boardState work = state;
+    if (propagateSingles(work, false) < 0)
+        return InvalidGrade;
+    if (work.filled == CellCount)
+        return NakedSinglesGrade;
+
+    work = state;
+    if (propagateSingles(work, true) < 0)
+        return InvalidGrade;
+    return work.filled == CellCount ? HiddenSinglesGrade : SearchGrade;
+}
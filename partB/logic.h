@@ -0,0 +1,36 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef LOGIC_RULES
+#define LOGIC_RULES
+
+#include "board.h"
+
+// Deductions that need no search, and the difficulty grade they give
+
+enum gradeType { NakedSinglesGrade, HiddenSinglesGrade, SearchGrade, InvalidGrade };
+
+const int UnitCount = 3 * BoardSize;    // Rows, then columns, then squares
+
+extern const int (&unitCells)[UnitCount][BoardSize];
+// cells of each unit
+
+const char *gradeName(gradeType grade);
+
+bool hasDuplicates(const boardState &state);
+// true if some value appears twice in a row, column or square
+
+int propagateSingles(boardState &state, bool hidden);
+// places naked singles (cells with one candidate) and, if hidden is true,
+// hidden singles (values with one place in a unit) until none is left.
+// returns the number of cells placed, or -1 on a contradiction
+
+bool findSingle(const boardState &state, bool hidden, int &cell, int &val, bool &isHidden);
+// finds the first naked single or, if hidden is true and there is none,
+// the first hidden single, without placing it. returns false if neither
+// rule applies
+
+gradeType gradePuzzle(const boardState &state);
+// the simplest rule set that solves the puzzle without guessing
+
+#endif  // LOGIC_RULES
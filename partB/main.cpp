@@ -0,0 +1,1242 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <cstring>
+#include <cstdlib>
+#include <sstream>
+#include "board.h"
+#include "pipeline.h"
+#include "alloccount.h"
+#include "perfcount.h"
+#include "archive.h"
+#include "source.h"
+#include "store.h"
+#include "validate.h"
+#include "session.h"
+#include "enumerate.h"
+#include "minimal.h"
+#include "variant.h"
+#include "shard.h"
+#include "golden.h"
+#include "metrics.h"
+#include "inputcheck.h"
+#include "topology.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <unistd.h>
+using namespace std;
+
+const int ValidateBatchSize = 4096; // Records validated per batch
+
+/** @brief Opens a puzzle file, text or archive
+ * @param fileName The file to open
+ * @param fin The stream used for a text file
+ * @param archive The mapping used for an archive
+ * @param text The source over fin
+ * @param binary The source over archive
+ * @return The source to read from
+*/
+puzzleSource &openPuzzles(const char *fileName, ifstream &fin, puzzleArchive &archive,
+                          textSource &text, archiveSource &binary)
+{
+    if (puzzleArchive::isArchive(fileName))
+    {
+        string error;
+        if (!archive.open(fileName, error))
+        {
+            cerr << "Cannot read archive " << fileName << ": " << error << endl;
+            exit(1);
+        }
+        return binary;
+    }
+
+    fin.open(fileName);   // Opens the file
+    if (!fin)
+    {
+        cerr << "Cannot open " << fileName << endl;   // Prints an error if the file cannot be opened
+        exit(1);    // Exits the program
+    }
+    return text;
+}
+
+/** @brief Writes one board as a line of sudoku.txt
+ * @param out The stream to write to
+ * @param cells The board
+ * @param last True for the final board, which is followed by the ending character
+ * @return None
+*/
+void writeTextRecord(ostream &out, const char *cells, bool last)
+{
+    out.write(cells, CellCount);
+    out << (last ? "Z" : "\n");
+}
+
+/** @brief Reads killer cages into a board
+ * @param fileName A file with one cage per line: the sum, then the cells as
+ *                 row and column digits, e.g. "15 11 12 21"
+ * @param b The board to add the cages to
+ * @return True if every cage was added, false otherwise
+*/
+bool loadCages(const char *fileName, board &b)
+{
+    ifstream fin(fileName);
+    if (!fin)
+    {
+        cerr << "Cannot open " << fileName << endl;
+        return false;
+    }
+
+    string line;
+    int lineNumber = 0;
+    while (getline(fin, line))
+    {
+        lineNumber++;
+        istringstream in(line);
+        int sum;
+        string cell;
+        if (!(in >> sum))
+            continue;   // Blank line
+        vector<pair<int, int> > cells;
+        while (in >> cell)
+        {
+            if (cell.size() != 2 || cell[0] < '1' || cell[0] > '9' || cell[1] < '1' || cell[1] > '9')
+            {
+                cerr << fileName << ":" << lineNumber << ": bad cell " << cell << endl;
+                return false;
+            }
+            cells.push_back(make_pair(cell[0] - '0', cell[1] - '0'));
+        }
+        if (!b.addCage(sum, cells))
+        {
+            cerr << fileName << ":" << lineNumber << ": cage overlaps another, repeats a cell or cannot reach " << sum
+                 << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/** @brief Converts puzzles between sudoku.txt form and an archive
+ * @param inName The file to read, text or archive
+ * @param outName The file to write, the other form
+ * @param solutionsName Text conversion only: file for the stored solutions, or NULL
+ * @param withSolutions Archive conversion only: solve each puzzle and store its solution
+ * @param engine The engine used to solve
+ * @return The exit status
+*/
+int convertPuzzles(const char *inName, const char *outName, const char *solutionsName,
+                   bool withSolutions, engineType engine)
+{
+    ifstream fin;
+    puzzleArchive archive;
+    textSource text(fin);
+    archiveSource binary(archive);
+    puzzleSource &source = openPuzzles(inName, fin, archive, text, binary);
+    char cells[CellCount], solution[CellCount];
+
+    if (&source == &text)   // Text to archive
+    {
+        archiveWriter writer;
+        if (!writer.open(outName, withSolutions))
+        {
+            cerr << "Cannot create " << outName << endl;
+            return 1;
+        }
+
+        board b(SquareSize);
+        board::prepare(engine);
+        inputReport report;
+        for (long puzzle = 0; source.next(cells); puzzle++)
+        {
+            checkPuzzle(cells, source.recordLength(), report);
+            for (int k = 0; k < report.count; k++)
+                if (report.issues[k].problem == BadLength || report.issues[k].problem == UnknownCharacter)
+                {
+                    printIssues(cerr, puzzle, report);  // The archive could only hold a different puzzle
+                    cerr << "Stopped at puzzle " << puzzle << ": it cannot be stored in " << outName << endl;
+                    return 1;
+                }
+            const char *solved = NULL;
+            if (withSolutions)
+            {
+                b.initialize(cells);
+                if (b.solve(engine))
+                {
+                    for (int k = 0; k < CellCount; k++)
+                        solution[k] = (char)('0' + b.getCell(k / BoardSize + 1, k % BoardSize + 1));
+                    solved = solution;
+                }
+            }
+            if (!writer.add(cells, solved))
+            {
+                cerr << "Cannot store puzzle " << puzzle << " in " << outName << endl;
+                return 1;
+            }
+        }
+        if (!writer.close())
+        {
+            cerr << "Cannot write " << outName << endl;
+            return 1;
+        }
+        cout << "Wrote " << writer.size() << " puzzles to " << outName << endl;
+        return 0;
+    }
+
+    ofstream fout(outName, ios::binary);    // Archive to text
+    ofstream sout;
+    if (solutionsName != NULL)
+        sout.open(solutionsName, ios::binary);
+    if (!fout || (solutionsName != NULL && !sout))
+    {
+        cerr << "Cannot create " << (fout ? solutionsName : outName) << endl;
+        return 1;
+    }
+
+    for (long n = 0; n < archive.size(); n++)
+    {
+        if (!source.next(cells))
+        {
+            cerr << "Cannot read " << inName << ": " << source.error() << endl;
+            return 1;
+        }
+        bool last = n + 1 == archive.size();
+        writeTextRecord(fout, cells, last);
+        if (solutionsName != NULL)
+        {
+            archive.getPuzzle(n, cells, solution);
+            writeTextRecord(sout, solution, last);
+        }
+    }
+    cout << "Wrote " << archive.size() << " puzzles to " << outName << endl;
+    return 0;
+}
+
+/** @brief Loads puzzles into a store and lists those matching a query
+ * @param fileName The puzzles, text or archive
+ * @param spec The query, see parseQuery
+ * @param engine The engine used to collect solve statistics
+ * @param numThreads The number of solver threads
+ * @return The exit status
+*/
+int queryPuzzles(const char *fileName, const char *spec, engineType engine, int numThreads)
+{
+    storeQuery query;
+    if (!parseQuery(spec, query))
+    {
+        cerr << "Cannot parse query " << spec << endl;
+        return 1;
+    }
+
+    ifstream fin;
+    puzzleArchive archive;
+    textSource text(fin);
+    archiveSource binary(archive);
+    puzzleStore store;
+    puzzleSource &source = openPuzzles(fileName, fin, archive, text, binary);
+    store.load(source);
+    if (!source.error().empty())
+    {
+        cerr << "Cannot load " << fileName << ": " << source.error() << endl;
+        return 1;
+    }
+
+    storeQuery indexed = query; // Conditions the indexes can answer before solving
+    indexed.minCalls = indexed.maxCalls = -1;
+    indexed.unsolvedOnly = false;
+    vector<long> candidates = store.find(indexed);
+    storeSolveStats stats = store.solve(candidates, engine, max(numThreads, 1));
+
+    vector<long> ids = store.find(query);
+    char cells[CellCount];
+    for (size_t k = 0; k < ids.size(); k++)
+    {
+        store.getCells(ids[k], cells);
+        cout << ids[k] << " clues=" << store.getClues(ids[k]) << " grade=" << gradeName(store.getGrade(ids[k]))
+             << " calls=" << store.getLastCalls(ids[k]) << " micros=" << store.getLastMicros(ids[k]) << " ";
+        cout.write(cells, CellCount);
+        cout << endl;
+    }
+    cout << ids.size() << " of " << store.size() << " puzzles match (" << stats.puzzles << " solved in "
+         << stats.seconds << " s)" << endl;
+    return 0;
+}
+
+/** @brief Validates submitted solutions against their puzzles in batches
+ * @param puzzleName The puzzles, text or archive
+ * @param solutionName The solutions, text or archive, in the same order
+ * @return The exit status, 1 if any solution is invalid
+*/
+int validateSolutions(const char *puzzleName, const char *solutionName)
+{
+    ifstream pin, sin;
+    puzzleArchive parchive, sarchive;
+    textSource ptext(pin), stext(sin);
+    archiveSource pbinary(parchive), sbinary(sarchive);
+    puzzleSource &puzzles = openPuzzles(puzzleName, pin, parchive, ptext, pbinary);
+    puzzleSource &solutions = openPuzzles(solutionName, sin, sarchive, stext, sbinary);
+
+    vector<char> pbuf(ValidateBatchSize * CellCount), sbuf(ValidateBatchSize * CellCount);
+    vector<unsigned char> results(ValidateBatchSize);
+    long total = 0, valid = 0;
+    double seconds = 0;
+
+    while (true)
+    {
+        long count = 0;
+        while (count < ValidateBatchSize && puzzles.next(&pbuf[count * CellCount]))
+        {
+            if (!solutions.next(&sbuf[count * CellCount]))
+            {
+                cerr << "Fewer solutions than puzzles" << endl;
+                return 1;
+            }
+            count++;
+        }
+        if (count == 0)
+            break;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        valid += validateBatch(&pbuf[0], &sbuf[0], count, &results[0]);
+        seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        for (long n = 0; n < count; n++)
+            if (results[n] != ValidSolution)
+                cout << "Solution " << total + n << ": " << validationName((validationResult)results[n]) << endl;
+        total += count;
+    }
+
+    if (!puzzles.error().empty() || !solutions.error().empty())
+    {
+        cerr << "Stopped early: " << puzzles.error() << solutions.error() << endl;
+        return 1;
+    }
+
+    cout << valid << " of " << total << " solutions are valid" << endl;
+    if (seconds > 0)
+        cout << "Validations per second: " << (long)(total / seconds) << endl;
+    return valid == total ? 0 : 1;
+}
+
+/** @brief Plays the first puzzle of a file with moves read from standard input
+ * @param fileName The puzzle file, text or archive
+ * @return The exit status
+ * @note Commands are "place ROW COL VALUE", "erase ROW COL", "cand ROW COL",
+ *       "check", "hint", "print" and "quit"
+*/
+int playPuzzle(const char *fileName)
+{
+    ifstream fin;
+    puzzleArchive archive;
+    textSource text(fin);
+    archiveSource binary(archive);
+    puzzleSource &source = openPuzzles(fileName, fin, archive, text, binary);
+    char cells[CellCount];
+    if (!source.next(cells))
+    {
+        cerr << "No puzzle in " << fileName << endl;
+        return 1;
+    }
+
+    playSession game;
+    game.start(cells);
+    string command;
+    while (cin >> command && command != "quit")
+    {
+        int i = 0, j = 0, val = 0;
+        try
+        {
+            if (command == "place" && cin >> i >> j >> val)
+                cout << (game.place(i, j, val) ? "ok" : "clue") << endl;
+            else if (command == "erase" && cin >> i >> j)
+                cout << (game.erase(i, j) ? "ok" : "clue") << endl;
+            else if (command == "cand" && cin >> i >> j)
+            {
+                unsigned short cand = game.candidates(i, j);
+                for (int k = MinValue; k <= MaxValue; k++)
+                    if (cand & (1 << (k - MinValue)))
+                        cout << k;
+                cout << endl;
+            }
+            else if (command == "check")
+                cout << (game.isSolved() ? "solved" : game.isSolvable() ? "solvable" : "unsolvable") << endl;
+            else if (command == "hint")
+            {
+                sessionHint h = game.hint();
+                cout << hintName(h.type);
+                if (h.type != NoHint)
+                    cout << " " << h.row << " " << h.col << " " << h.value;
+                cout << endl;
+            }
+            else if (command == "print")
+                game.print();
+            else
+            {
+                cout << "unknown command" << endl;
+                cin.clear();
+            }
+        }
+        catch (baseException &ex)
+        {
+            cout << ex.what() << endl;
+        }
+    }
+    return 0;
+}
+
+/** @brief Walks the solutions of every puzzle in a file
+ * @param fileName The puzzle file, text or archive
+ * @param limit Solutions to walk per puzzle, 0 for all
+ * @param numThreads Enumerator threads; with more than one, solutions are only counted
+ * @return The exit status
+*/
+int enumeratePuzzles(const char *fileName, long limit, int numThreads)
+{
+    ifstream fin;
+    puzzleArchive archive;
+    textSource text(fin);
+    archiveSource binary(archive);
+    puzzleSource &source = openPuzzles(fileName, fin, archive, text, binary);
+    char cells[CellCount], solution[CellCount];
+    board b1(SquareSize);
+    solutionEnumerator walk;
+    long puzzle = 0;
+
+    try
+    {
+        while (source.next(cells))
+        {
+            b1.initialize(cells);
+            long count = 0;
+            if (numThreads > 1)
+                count = countSolutions(b1.getState(), limit, numThreads);
+            else
+            {
+                walk.start(b1.getState());
+                while ((limit == 0 || count < limit) && walk.next(solution))
+                {
+                    cout.write(solution, CellCount);
+                    cout << endl;
+                    count++;
+                }
+            }
+            cout << "Puzzle " << puzzle++ << ": " << count << (limit != 0 && count == limit ? "+" : "")
+                 << " solutions" << endl;
+        }
+    }
+    catch (baseException &ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    if (!source.error().empty())
+    {
+        cerr << "Stopped early: " << source.error() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+/** @brief Checks that every puzzle in a file is unique and has no redundant clue
+ * @param fileName The puzzle file, text or archive
+ * @param numThreads The number of probe threads
+ * @return The exit status, 1 if any puzzle is not minimal
+*/
+int checkPuzzles(const char *fileName, int numThreads)
+{
+    ifstream fin;
+    puzzleArchive archive;
+    textSource text(fin);
+    archiveSource binary(archive);
+    puzzleSource &source = openPuzzles(fileName, fin, archive, text, binary);
+    char cells[CellCount];
+    minimalityReport report;
+    long puzzle = 0, minimal = 0;
+
+    try
+    {
+        while (source.next(cells))
+        {
+            cout << "Puzzle " << puzzle++ << ": ";
+            if (checkMinimality(cells, max(numThreads, 1), report))
+            {
+                cout << "minimal";
+                minimal++;
+            }
+            else if (!report.solvable)
+                cout << "no solution";
+            else if (!report.unique)
+                cout << "not unique";
+            else
+            {
+                cout << report.redundantCount << " redundant clues:";
+                for (int cell = 0; cell < CellCount; cell++)
+                    if (report.redundant[cell])
+                        cout << " r" << cell / BoardSize + 1 << "c" << cell % BoardSize + 1;
+            }
+            cout << " (" << report.implied << " implied, " << report.searched << " searched)" << endl;
+        }
+    }
+    catch (baseException &ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    if (!source.error().empty())
+    {
+        cerr << "Stopped early: " << source.error() << endl;
+        return 1;
+    }
+    cout << minimal << " of " << puzzle << " puzzles are minimal" << endl;
+    return minimal == puzzle ? 0 : 1;
+}
+
+/** @brief Records the golden search counts of every puzzle in a file
+ * @param fileName The puzzle file, text or archive
+ * @param goldenName The golden file to write
+ * @return The exit status
+*/
+int recordGolden(const char *fileName, const char *goldenName)
+{
+    ifstream fin;
+    puzzleArchive archive;
+    textSource text(fin);
+    archiveSource binary(archive);
+    puzzleSource &source = openPuzzles(fileName, fin, archive, text, binary);
+    ofstream out(goldenName);
+    if (!out)
+    {
+        cerr << "Cannot write " << goldenName << endl;
+        return 1;
+    }
+    char cells[CellCount];
+    goldenRecord record;
+    long puzzle = 0;
+
+    out << "# Golden search counts for " << fileName << endl;
+    out << "# puzzle engine nodes backtracks propagations solution" << endl;
+    try
+    {
+        for (; source.next(cells); puzzle++)
+            for (int e = 0; e < EngineCount; e++)
+            {
+                record.puzzle = puzzle;
+                measureSearch(cells, (engineType)e, record);
+                writeGolden(out, record);
+            }
+    }
+    catch (baseException &ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    if (!source.error().empty())
+    {
+        cerr << "Stopped early: " << source.error() << endl;
+        return 1;
+    }
+    cout << puzzle << " puzzles recorded in " << goldenName << endl;
+    return out ? 0 : 1;
+}
+
+/** @brief Checks the search counts of a puzzle file against a golden file
+ * @param fileName The puzzle file, text or archive
+ * @param goldenName The golden file written by recordGolden
+ * @param tolerance The growth allowed in any count, in percent
+ * @return The exit status, 1 if any record fails
+*/
+int checkGolden(const char *fileName, const char *goldenName, double tolerance)
+{
+    ifstream golden(goldenName);
+    if (!golden)
+    {
+        cerr << "Cannot read " << goldenName << endl;
+        return 1;
+    }
+    ifstream fin;
+    puzzleArchive archive;
+    textSource text(fin);
+    archiveSource binary(archive);
+    puzzleSource &source = openPuzzles(fileName, fin, archive, text, binary);
+    char cells[CellCount];
+    goldenRecord expected, actual;
+    long puzzle = -1, records = 0, failed = 0, changed = 0;
+
+    try
+    {
+        while (readGolden(golden, expected))
+        {
+            while (puzzle < expected.puzzle && source.next(cells))
+                puzzle++;   // Records are in puzzle order, one per engine
+            if (puzzle != expected.puzzle)
+            {
+                cout << "Puzzle " << expected.puzzle << ": not in " << fileName << " FAIL" << endl;
+                failed++;
+                break;
+            }
+            actual.puzzle = puzzle;
+            measureSearch(cells, expected.engine, actual);
+            records++;
+            if (!compareGolden(expected, actual, tolerance, cout))
+                failed++;
+            else if (actual.counts.nodes != expected.counts.nodes
+                     || actual.counts.backtracks != expected.counts.backtracks
+                     || actual.counts.propagations != expected.counts.propagations)
+                changed++;
+        }
+    }
+    catch (baseException &ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    if (!golden.eof() && failed == 0)
+    {
+        cerr << "Malformed record in " << goldenName << endl;
+        return 1;
+    }
+    if (!source.error().empty())
+    {
+        cerr << "Stopped early: " << source.error() << endl;
+        return 1;
+    }
+    cout << records << " records checked: " << failed << " failed, " << changed << " changed within tolerance"
+         << endl;
+    return failed == 0 ? 0 : 1;
+}
+
+/** @brief Keeps only the problems with the form of a record
+ * @param report The problems, reduced to bad lengths and unknown characters
+ * @return True if any problem is left, false otherwise
+ * @note Jigsaw regions take the place of the squares, so a clue the check
+ *       finds repeated in a square may still be allowed
+*/
+bool keepFormatIssues(inputReport &report)
+{
+    int kept = 0;
+    for (int k = 0; k < report.count; k++)
+        if (report.issues[k].problem == BadLength || report.issues[k].problem == UnknownCharacter)
+            report.issues[kept++] = report.issues[k];
+    report.count = kept;
+    return kept > 0;
+}
+
+/** @brief Solves every puzzle in a file under a variant's rules
+ * @param fileName The puzzle file, text or archive
+ * @param regions Jigsaw only: the region of every cell, or NULL
+ * @return The exit status
+*/
+template <typename Rules>
+int solveVariant(const char *fileName, const char *regions)
+{
+    ifstream fin;
+    puzzleArchive archive;
+    textSource text(fin);
+    archiveSource binary(archive);
+    puzzleSource &source = openPuzzles(fileName, fin, archive, text, binary);
+    char cells[CellCount];
+    variantBoard<Rules> b1;
+    long calls = 0, solved = 0, puzzle = 0;
+    inputReport report;
+
+    if (Rules::Jigsaw && (regions == NULL || strlen(regions) != CellCount || !b1.setRegions(regions)))
+    {
+        cerr << "Jigsaw needs --regions with " << CellCount << " region digits" << endl;
+        return 1;
+    }
+
+    try
+    {
+        for (; source.next(cells); puzzle++)
+        {
+            if (!checkPuzzle(cells, source.recordLength(), report) && (!Rules::Jigsaw || keepFormatIssues(report)))
+            {
+                printIssues(cout, puzzle, report);  // Rejected before any search
+                cout << "Sudoku board is not solved." << endl;
+                continue;
+            }
+            b1.resetCallCount();
+            if (!b1.initialize(cells))
+            {
+                cout << "Sudoku board is not solved." << endl;    // The givens clash under the variant's rules
+                continue;
+            }
+            b1.print();
+            if (b1.solve())
+            {
+                b1.print();
+                cout << "Sudoku board is solved!" << endl;
+                cout << "Number of recursive calls: " << b1.getCallCount() << endl;
+                solved++;
+                calls += b1.getCallCount();
+            }
+            else
+                cout << "Sudoku board is not solved." << endl;
+        }
+    }
+    catch (baseException &ex)
+    {
+        cout << ex.what() << endl;
+        return 1;
+    }
+
+    cout << "Total number of recursive calls: " << calls << endl;
+    if (solved > 0)
+        cout << "Average number of recursive calls: " << calls / solved << endl;
+    if (!source.error().empty())
+    {
+        cerr << "Stopped early: " << source.error() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+/** @brief Solves every puzzle of a source and prints the results
+ * @param source The puzzles
+ * @param out The stream to print to
+ * @param engine The engine to solve with
+ * @param numThreads Solver threads in the pipeline, 0 to solve on this thread
+ * @param profile True to report performance counters
+ * @param cagesName Killer cages for every puzzle, or NULL
+ * @param totals Accumulates the totals
+ * @param checkpoints Receives checkpoints as results are written, or NULL
+ * @param metrics Live counters, or NULL
+ * @param pinning The processors to pin the solvers to, or NULL
+ * @return None
+*/
+void solvePuzzles(puzzleSource &source, ostream &out, engineType engine, int numThreads, bool profile,
+                  const char *cagesName, runStats &totals, checkpointWriter *checkpoints, liveMetrics *metrics,
+                  const cpuTopology *pinning)
+{
+    char cells[CellCount];
+
+    if (numThreads > 0)
+        runPipeline(source, out, engine, numThreads, profile, totals, checkpoints, metrics, pinning);
+    else try
+    {
+        if (pinning != NULL)
+            pinThread(pinning->slot(0).cpu);    // This thread is the only solver
+        board b1(SquareSize);   // Creates a board
+        board::prepare(engine); // Sets up the engine so solving does not allocate
+        if (cagesName != NULL && !loadCages(cagesName, b1))
+            exit(1);
+        perfCounters counters;
+        perfSample sample;
+        inputReport report;
+        while (source.next(cells))  // While the file is not empty and the ending character isn't encountered
+        {
+            if (!checkPuzzle(cells, source.recordLength(), report))
+            {
+                printIssues(out, totals.puzzles, report);   // Rejected before any search
+                out << "Sudoku board is not solved." << endl;
+                totals.puzzles++;
+                continue;
+            }
+            b1.initialize(cells);   // Initializes the board
+            b1.print(out); // Prints the board
+            long allocations = threadAllocations();
+            chrono::steady_clock::time_point begin;
+            if (metrics != NULL)
+                begin = chrono::steady_clock::now();
+            if (profile)
+                counters.start();
+            b1.solve(engine);   // Solves the board
+            if (profile)
+                counters.stop(sample);
+            if (metrics != NULL)
+            {
+                chrono::nanoseconds elapsed = chrono::steady_clock::now() - begin;
+                metrics->forThread(0).record(totals.puzzles, cells, (long)elapsed.count(), b1.getCallCount(),
+                                             b1.isSolved());
+            }
+            allocations = threadAllocations() - allocations;
+            totals.puzzles++;
+            totals.allocations += allocations;
+            if (b1.isSolved())  // If the board is solved, print the board and the number of recursive calls
+            {
+                b1.print(out);
+                out << "Sudoku board is solved!" << endl;
+                out << "Number of recursive calls: " << b1.getCallCount() << endl;
+                totals.solved++;    // Increments the total number of solved boards
+                totals.calls += b1.getCallCount();  // Increments the total call count
+                b1.resetCallCount();
+            }
+            else    // If the board is not solved, print an error message
+            {
+                out << "Sudoku board is not solved." << endl;
+            }
+            if (allocationTracking())
+                out << "Heap allocations during solve: " << allocations << endl;
+            if (profile)
+            {
+                out << "Counters (" << engineName(engine) << "): ";
+                sample.print(out);
+                totals.counters.add(sample);
+            }
+            if (checkpoints != NULL && checkpoints->due())
+            {
+                out.flush();
+                checkpoint state = { source.position(), (long)out.tellp(), totals };
+                checkpoints->submit(state); // Saved by the checkpoint thread
+            }
+        }
+        if (checkpoints != NULL)
+        {
+            out.flush();
+            checkpoint state = { source.position(), (long)out.tellp(), totals };
+            checkpoints->submit(state);
+        }
+    }
+    catch (baseException &ex)
+    {
+        out << ex.what() << endl;  // Prints an error message
+        exit(1);    // Exits the program
+    }
+}
+
+/** @brief Prints the totals over every solved puzzle
+ * @param out The stream to print to
+ * @param engine The engine used
+ * @param profile True if performance counters were read
+ * @param totals The totals
+ * @return None
+*/
+void printTotals(ostream &out, engineType engine, bool profile, const runStats &totals)
+{
+    out << "Total number of recursive calls: " << totals.calls << endl; // Prints the total number of recursive calls
+    if (totals.solved > 0)
+        out << "Average number of recursive calls: " << totals.calls / totals.solved << endl;  // Prints the average number of recursive calls
+    if (allocationTracking())
+        out << "Total heap allocations during solves: " << totals.allocations << endl;
+    if (profile)
+    {
+        out << "Total counters (" << engineName(engine) << "): ";
+        totals.counters.print(out);
+    }
+}
+
+/** @brief Copies a shard's results, numbering its puzzles as in the whole file
+ * @param in The shard's results, with puzzles numbered from 0
+ * @param out The stream to copy to
+ * @param first The number of puzzles before the shard
+ * @return None
+*/
+void copyShardOutput(istream &in, ostream &out, long first)
+{
+    if (in.peek() == EOF)
+        return;
+    if (first == 0)
+    {
+        out << in.rdbuf();
+        return;
+    }
+
+    const string tag = "input-error puzzle=";
+    string line;
+    while (getline(in, line))
+    {
+        if (line.compare(0, tag.size(), tag) == 0)
+        {
+            size_t end = line.find(' ', tag.size());
+            long puzzle = atol(line.c_str() + tag.size()) + first;
+            line = tag + to_string(puzzle) + (end == string::npos ? "" : line.substr(end));
+        }
+        out << line << '\n';
+    }
+}
+
+/** @brief Solves a puzzle file in worker processes, one per shard, and merges their results
+ * @param fileName The puzzle file, text or archive
+ * @param shards The number of worker processes
+ * @param engine The engine to solve with
+ * @param numThreads Solver threads in each worker's pipeline, 0 for none
+ * @param profile True to report performance counters
+ * @param cagesName Killer cages for every puzzle, or NULL
+ * @param totals Accumulates the totals of every shard
+ * @param pinning The processors to pin the solvers to, or NULL; each shard takes the next ones in order
+ * @return The exit status
+*/
+int shardPuzzles(const char *fileName, int shards, engineType engine, int numThreads, bool profile,
+                 const char *cagesName, runStats &totals, const cpuTopology *pinning)
+{
+    bool isArchive = puzzleArchive::isArchive(fileName);
+    vector<long> bounds;    // Where each shard starts, in bytes or in blocks
+    if (isArchive)
+    {
+        puzzleArchive archive;
+        string error;
+        if (!archive.open(fileName, error))
+        {
+            cerr << "Cannot read archive " << fileName << ": " << error << endl;
+            return 1;
+        }
+        for (int k = 0; k <= shards; k++)
+            bounds.push_back((long)archive.blockCount() * k / shards);  // Whole blocks per shard
+    }
+    else if (!splitText(fileName, shards, bounds))
+    {
+        cerr << "Cannot open " << fileName << endl;
+        return 1;
+    }
+
+    string dir = makeScratchDir();
+    if (dir.empty())
+    {
+        cerr << "Cannot create a directory for shard files" << endl;
+        return 1;
+    }
+
+    auto work = [&](int shard) -> int
+    {
+        ifstream fin;
+        puzzleArchive archive;
+        textSource text(fin);
+        archiveSource binary(archive);
+        puzzleSource &source = openPuzzles(fileName, fin, archive, text, binary);
+        if (isArchive)
+            binary.setBlocks((int)bounds[shard], (int)bounds[shard + 1]);
+        else
+            text.setRange(bounds[shard], bounds[shard + 1]);
+
+        unique_ptr<cpuTopology> shardPinning;
+        if (pinning != NULL)
+        {
+            shardPinning.reset(new cpuTopology(*pinning));
+            shardPinning->skip(shard * max(numThreads, 1));    // Past the processors of the shards before
+        }
+
+        ofstream out(shardFile(dir, shard, ".out").c_str());
+        runStats shardTotals;
+        shardTotals.clear();
+        solvePuzzles(source, out, engine, numThreads, profile, cagesName, shardTotals, NULL, NULL, shardPinning.get());
+        bool ended = false; // Stopped at the ending character, so the shards after hold no puzzles
+        if (!isArchive)
+        {
+            fin.clear();
+            ended = fin.peek() == 'Z' && (long)fin.tellg() < bounds[shard + 1];
+        }
+        ofstream stats(shardFile(dir, shard, ".stats").c_str());
+        shardTotals.write(stats);
+        stats << ended << endl;
+        return source.error().empty() && out && stats ? 0 : 1;
+    };
+    bool ok = runShards(shards, work, cerr);
+
+    long first = 0; // Puzzles read by the shards before
+    for (int shard = 0; shard < shards; shard++)   // Merges in input order
+    {
+        ifstream out(shardFile(dir, shard, ".out").c_str());
+        ifstream stats(shardFile(dir, shard, ".stats").c_str());
+        runStats shardTotals;
+        bool ended;
+        if (!shardTotals.read(stats) || !(stats >> ended))
+            continue;   // The shard never finished
+        copyShardOutput(out, cout, first);
+        totals.add(shardTotals);
+        first += shardTotals.puzzles;
+        if (ended)
+            break;
+    }
+    removeScratchDir(dir, shards);
+
+    if (!ok)
+        cerr << "Stopped early: some shards failed" << endl;
+    printTotals(cout, engine, profile, totals);
+    return ok ? 0 : 1;
+}
+
+/** @brief Measures how solving scales as threads are added socket by socket
+ * @param fileName The puzzle file, text or archive
+ * @param engine The engine to solve with
+ * @return The exit status
+ * @note Solves the file with one pinned thread, with the cores of the
+ *       first socket, of the first two and so on, and with every
+ *       processor, then once more with every processor unpinned
+*/
+int measureScaling(const char *fileName, engineType engine)
+{
+    cpuTopology topology;
+    topology.report(cout);
+
+    vector<int> counts(1, 1);
+    for (int s = 1; s <= topology.socketCount(); s++)
+        counts.push_back(topology.coresIn(s));
+    counts.push_back(topology.cpuCount());
+    sort(counts.begin(), counts.end());
+    counts.erase(unique(counts.begin(), counts.end()), counts.end());
+
+    double baseRate = 0;
+    for (size_t k = 0; k <= counts.size(); k++)
+    {
+        bool pinned = k < counts.size();
+        int threads = pinned ? counts[k] : topology.cpuCount();
+        ifstream fin;
+        puzzleArchive archive;
+        textSource text(fin);
+        archiveSource binary(archive);
+        puzzleSource &source = openPuzzles(fileName, fin, archive, text, binary);
+        ostream discard(NULL);  // Only the time is wanted
+        runStats totals;
+        totals.clear();
+
+        chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+        solvePuzzles(source, discard, engine, threads, false, NULL, totals, NULL, NULL, pinned ? &topology : NULL);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        if (!source.error().empty())
+        {
+            cerr << "Stopped early: " << source.error() << endl;
+            return 1;
+        }
+
+        vector<int> sockets;
+        for (int t = 0; t < threads; t++)
+            sockets.push_back(topology.slot(t).socket);
+        sort(sockets.begin(), sockets.end());
+        double rate = seconds > 0 ? totals.puzzles / seconds : 0;
+        if (k == 0)
+            baseRate = rate;
+        cout << "scaling threads=" << threads << " sockets=" << unique(sockets.begin(), sockets.end()) - sockets.begin()
+             << " pinned=" << pinned << " puzzles=" << totals.puzzles << " seconds=" << seconds << " rate=" << rate
+             << " speedup=" << (baseRate > 0 ? rate / baseRate : 0) << endl;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    engineType engine = BacktrackEngine;
+    const char *fileName = "sudoku.txt";
+    int numThreads = 0; // 0 solves on the main thread without the pipeline
+    bool profile = false;   // Reports performance counters for every solve
+    int shards = 0; // 0 solves in this process
+    const char *outputName = NULL, *checkpointName = NULL;
+    bool resume = false;
+    const char *convertIn = NULL, *convertOut = NULL, *solutionsName = NULL, *querySpec = NULL;
+    const char *validateIn = NULL, *validateAgainst = NULL;
+    bool withSolutions = false;
+    bool play = false;  // Plays the first puzzle interactively
+    variantType variant = ClassicVariant;
+    bool useVariant = false;    // Solves under a variant's rules
+    const char *regions = NULL; // Jigsaw regions
+    const char *cagesName = NULL;
+    bool minimalCheck = false;  // Checks puzzles for redundant clues
+    long enumerateLimit = -1;   // Solutions to walk per puzzle, 0 for all
+    const char *goldenName = NULL, *recordName = NULL;
+    const char *metricsName = NULL;  // Snapshot file, or "-" for a line per snapshot
+    int slowest = -1;   // Slowest puzzles to list
+    double tolerance = 0;   // Percent growth allowed in a golden count
+    bool pin = false;   // Pins solver threads to processors, filling one socket first
+    bool showTopology = false, scaling = false;
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if (strcmp(argv[arg], "-e") == 0 && arg + 1 < argc)
+        {
+            if (!parseEngine(argv[++arg], engine))
+            {
+                cerr << "Unknown engine " << argv[arg] << endl;
+                exit(1);
+            }
+        }
+        else if (strcmp(argv[arg], "-p") == 0)
+            profile = true;
+        else if (strcmp(argv[arg], "-t") == 0 && arg + 1 < argc)
+            numThreads = atoi(argv[++arg]); // Number of solver threads in the pipeline
+        else if (strcmp(argv[arg], "-o") == 0 && arg + 1 < argc)
+            outputName = argv[++arg];   // Writes the results to a file
+        else if (strcmp(argv[arg], "--checkpoint") == 0 && arg + 1 < argc)
+            checkpointName = argv[++arg];   // Saves progress every few seconds
+        else if (strcmp(argv[arg], "--resume") == 0)
+            resume = true;  // Continues from the checkpoint
+        else if (strcmp(argv[arg], "--shards") == 0 && arg + 1 < argc)
+            shards = atoi(argv[++arg]); // Number of worker processes
+        else if ((strcmp(argv[arg], "--to-binary") == 0 || strcmp(argv[arg], "--to-text") == 0) && arg + 2 < argc)
+        {
+            convertIn = argv[++arg];    // Converts instead of solving
+            convertOut = argv[++arg];
+        }
+        else if (strcmp(argv[arg], "--validate") == 0 && arg + 2 < argc)
+        {
+            validateIn = argv[++arg];
+            validateAgainst = argv[++arg];
+        }
+        else if (strcmp(argv[arg], "--enumerate") == 0 && arg + 1 < argc)
+            enumerateLimit = atol(argv[++arg]); // Walks solutions instead of solving
+        else if (strcmp(argv[arg], "--variant") == 0 && arg + 1 < argc)
+        {
+            if (!parseVariant(argv[++arg], variant))
+            {
+                cerr << "Unknown variant " << argv[arg] << endl;
+                exit(1);
+            }
+            useVariant = true;
+        }
+        else if (strcmp(argv[arg], "--cages") == 0 && arg + 1 < argc)
+            cagesName = argv[++arg];    // Killer cages for every puzzle
+        else if (strcmp(argv[arg], "--regions") == 0 && arg + 1 < argc)
+            regions = argv[++arg];
+        else if (strcmp(argv[arg], "--minimal") == 0)
+            minimalCheck = true;
+        else if (strcmp(argv[arg], "--metrics") == 0 && arg + 1 < argc)
+            metricsName = argv[++arg];  // Reports live metrics while solving
+        else if (strcmp(argv[arg], "--slowest") == 0 && arg + 1 < argc)
+            slowest = atoi(argv[++arg]);
+        else if (strcmp(argv[arg], "--golden") == 0 && arg + 1 < argc)
+            goldenName = argv[++arg];   // Checks search counts against a golden file
+        else if (strcmp(argv[arg], "--record-golden") == 0 && arg + 1 < argc)
+            recordName = argv[++arg];
+        else if (strcmp(argv[arg], "--tolerance") == 0 && arg + 1 < argc)
+            tolerance = atof(argv[++arg]);
+        else if (strcmp(argv[arg], "--pin") == 0)
+            pin = true;
+        else if (strcmp(argv[arg], "--topology") == 0)
+            showTopology = true;    // Prints the processors and the pinning order
+        else if (strcmp(argv[arg], "--scaling") == 0)
+            scaling = true;     // Times the file at growing thread counts
+        else if (strcmp(argv[arg], "--play") == 0)
+            play = true;
+        else if (strcmp(argv[arg], "--query") == 0 && arg + 1 < argc)
+            querySpec = argv[++arg];
+        else if (strcmp(argv[arg], "--with-solutions") == 0)
+            withSolutions = true;
+        else if (strcmp(argv[arg], "--solutions") == 0 && arg + 1 < argc)
+            solutionsName = argv[++arg];
+        else
+            fileName = argv[arg];   // Any other argument is the puzzle file
+    }
+
+    if (convertIn != NULL)
+        return convertPuzzles(convertIn, convertOut, solutionsName, withSolutions, engine);
+    if (validateIn != NULL)
+        return validateSolutions(validateIn, validateAgainst);
+    if (play)
+        return playPuzzle(fileName);
+    if (recordName != NULL)
+        return recordGolden(fileName, recordName);
+    if (goldenName != NULL)
+        return checkGolden(fileName, goldenName, tolerance);
+    if (useVariant)
+    {
+        switch (variant)
+        {
+        case DiagonalVariant:
+            return solveVariant<diagonalRules>(fileName, regions);
+        case WindokuVariant:
+            return solveVariant<windokuRules>(fileName, regions);
+        case AntiKnightVariant:
+            return solveVariant<antiKnightRules>(fileName, regions);
+        case JigsawVariant:
+            return solveVariant<jigsawRules>(fileName, regions);
+        default:
+            return solveVariant<classicRules>(fileName, regions);
+        }
+    }
+    if (minimalCheck)
+        return checkPuzzles(fileName, numThreads);
+    if (enumerateLimit >= 0)
+        return enumeratePuzzles(fileName, enumerateLimit, numThreads);
+    if (querySpec != NULL)
+        return queryPuzzles(fileName, querySpec, engine, numThreads);
+    if (showTopology)
+    {
+        cpuTopology().report(cout);
+        return 0;
+    }
+    if (scaling)
+        return measureScaling(fileName, engine);
+
+    runStats totals;
+    totals.clear();
+    if (profile && !perfCounters().available())
+    {
+        cerr << "Performance counters are not available, continuing without them" << endl;
+        profile = false;
+    }
+
+    if (cagesName != NULL && numThreads > 0)
+    {
+        cerr << "Puzzles with cages are solved on the main thread" << endl;
+        numThreads = 0;
+    }
+    if (cagesName != NULL && engine != BacktrackEngine)
+    {
+        cerr << "Puzzles with cages are solved by backtracking, not " << engineName(engine) << endl;
+        engine = BacktrackEngine;   // Counters are then reported under the engine that ran
+    }
+
+    unique_ptr<cpuTopology> pinning;
+    if (pin)
+        pinning.reset(new cpuTopology());
+
+    if (shards > 0)
+    {
+        if (checkpointName != NULL || metricsName != NULL || slowest >= 0)
+        {
+            cerr << "Checkpoints and live metrics are not kept for sharded runs" << endl;
+            return 1;
+        }
+        return shardPuzzles(fileName, shards, engine, numThreads, profile, cagesName, totals, pinning.get());
+    }
+    if ((checkpointName != NULL || resume) && (outputName == NULL || checkpointName == NULL))
+    {
+        cerr << "Checkpoints need both --checkpoint FILE and -o FILE" << endl;
+        return 1;
+    }
+
+    ifstream fin;
+    puzzleArchive archive;
+    textSource text(fin);
+    archiveSource binary(archive);
+    puzzleSource &source = openPuzzles(fileName, fin, archive, text, binary);
+
+    ofstream fout;
+    if (resume)
+    {
+        checkpoint state;
+        if (!loadCheckpoint(checkpointName, state))
+        {
+            cerr << "Cannot read checkpoint " << checkpointName << endl;
+            return 1;
+        }
+        if (truncate(outputName, state.output) != 0 || !source.seek(state.input))
+        {
+            cerr << "Cannot resume " << outputName << " from " << checkpointName << endl;
+            return 1;
+        }
+        fout.open(outputName, ios::in | ios::out);  // Keeps the results written before the checkpoint
+        fout.seekp(0, ios::end);
+        totals = state.stats;
+    }
+    else if (outputName != NULL)
+        fout.open(outputName);
+    if (outputName != NULL && !fout)
+    {
+        cerr << "Cannot write " << outputName << endl;
+        return 1;
+    }
+    ostream &out = outputName != NULL ? (ostream &)fout : cout;
+
+    {
+        unique_ptr<checkpointWriter> checkpoints;
+        if (checkpointName != NULL)
+            checkpoints.reset(new checkpointWriter(checkpointName));
+        unique_ptr<liveMetrics> metrics;
+        if (metricsName != NULL || slowest >= 0)  // Lines go to stderr unless the results have a file
+            metrics.reset(new liveMetrics(metricsName != NULL ? metricsName : "-", outputName != NULL ? cout : cerr,
+                                          numThreads, max(slowest, 0)));
+        solvePuzzles(source, out, engine, numThreads, profile, cagesName, totals, checkpoints.get(), metrics.get(),
+                     pinning.get());
+        if (metrics && metrics->failed())
+            cerr << "Some metrics snapshots could not be written to " << metricsName << endl;
+        if (checkpoints && checkpoints->failed())
+            cerr << "Some checkpoints could not be saved to " << checkpointName << endl;
+    }   // Saves the last checkpoint and metrics snapshot
+    if (!source.error().empty())
+        cerr << "Stopped early: " << source.error() << endl;
+    printTotals(out, engine, profile, totals);
+
+    return source.error().empty() ? 0 : 1;
+}
\ No newline at end of file
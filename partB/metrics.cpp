@@ -0,0 +1,334 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include "metrics.h"
+using namespace std;
+
+/** @brief Adds one to a counter only this thread writes
+ * @param counter The counter
+ * @param amount The amount to add
+ * @return None
+ * @note A plain load and store, with no locked instruction
+*/
+inline void bump(atomic<long> &counter, long amount)
+{
+    counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+/** @brief Constructor for logHistogram class
+ * @param None
+ * @return None
+*/
+logHistogram::logHistogram()
+{
+    for (int b = 0; b < HistogramBuckets; b++)
+        counts[b].store(0, memory_order_relaxed);
+}
+
+/** @brief Finds the bucket of a value
+ * @param value The value
+ * @return The bucket number
+*/
+int logHistogram::bucketOf(unsigned long value)
+{
+    const unsigned long direct = 1UL << HistogramSubBits;
+    if (value < direct)
+        return (int)value;
+    int top = 63 - __builtin_clzl(value);   // Highest set bit
+    return ((top - HistogramSubBits + 1) << HistogramSubBits) + (int)((value >> (top - HistogramSubBits)) & (direct - 1));
+}
+
+/** @brief Gets the smallest value in a bucket
+ * @param bucket The bucket number
+ * @return The value
+*/
+unsigned long logHistogram::bucketLow(int bucket)
+{
+    const int direct = 1 << HistogramSubBits;
+    if (bucket < direct)
+        return bucket;
+    int top = (bucket >> HistogramSubBits) + HistogramSubBits - 1;
+    return (unsigned long)(direct + (bucket & (direct - 1))) << (top - HistogramSubBits);
+}
+
+/** @brief Counts a value
+ * @param value The value
+ * @return None
+*/
+void logHistogram::record(unsigned long value)
+{
+    bump(counts[bucketOf(value)], 1);
+}
+
+/** @brief Adds the bucket counts to totals
+ * @param totals HistogramBuckets totals
+ * @return None
+*/
+void logHistogram::addTo(long *totals) const
+{
+    for (int b = 0; b < HistogramBuckets; b++)
+        totals[b] += counts[b].load(memory_order_relaxed);
+}
+
+/** @brief Finds a percentile of counted values
+ * @param counts HistogramBuckets counts
+ * @param fraction The fraction of values at or below the result, 0 to 1
+ * @return The smallest value of the bucket holding the percentile
+*/
+unsigned long logHistogram::percentile(const long *counts, double fraction)
+{
+    long total = 0;
+    for (int b = 0; b < HistogramBuckets; b++)
+        total += counts[b];
+    if (total == 0)
+        return 0;
+
+    long rank = max(1L, (long)(fraction * total + 0.999999));
+    for (int b = 0; b < HistogramBuckets; b++)
+        if ((rank -= counts[b]) <= 0)
+            return bucketLow(b);
+    return bucketLow(HistogramBuckets - 1);
+}
+
+/** @brief Constructor for threadMetrics struct
+ * @param None
+ * @return None
+*/
+threadMetrics::threadMetrics() : solves(0), solved(0), calls(0), longest(0), mostCalls(0), version(0), keep(0),
+                                 slowCount(0), threshold(0)
+{
+}
+
+/** @brief Counts one solve
+ * @param puzzle The puzzle's position in the input
+ * @param cells The puzzle, BoardSize * BoardSize characters
+ * @param nanoseconds The time the solve took
+ * @param calls The recursive calls made
+ * @param isSolved True if the board was solved
+ * @return None
+*/
+void threadMetrics::record(long puzzle, const char *cells, long nanoseconds, long calls, bool isSolved)
+{
+    bump(solves, 1);
+    if (isSolved)
+    {
+        bump(solved, 1);
+        bump(this->calls, calls);
+    }
+    latency.record(nanoseconds);
+    nodes.record(calls);
+    if (nanoseconds > longest.load(memory_order_relaxed))
+        longest.store(nanoseconds, memory_order_relaxed);
+    if (calls > mostCalls.load(memory_order_relaxed))
+        mostCalls.store(calls, memory_order_relaxed);
+
+    if (keep == 0 || (slowCount == keep && nanoseconds <= threshold))
+        return; // Most solves stop here
+
+    unsigned v = version.load(memory_order_relaxed);
+    version.store(v + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    int slot = slowCount < keep ? slowCount++ : 0;
+    for (int k = 1; slowCount == keep && k < slowCount; k++)
+        if (slowest[k].nanoseconds < slowest[slot].nanoseconds)
+            slot = k;   // Replaces the fastest of a full list
+    slowest[slot].puzzle = puzzle;
+    slowest[slot].nanoseconds = nanoseconds;
+    slowest[slot].calls = calls;
+    memcpy(slowest[slot].cells, cells, CellCount);
+    if (slowCount == keep)
+    {
+        threshold = slowest[0].nanoseconds;
+        for (int k = 1; k < slowCount; k++)
+            threshold = min(threshold, slowest[k].nanoseconds);
+    }
+
+    version.store(v + 2, memory_order_release);
+}
+
+/** @brief Copies the slowest puzzles
+ * @param out Set to the list, room for MaxSlowest
+ * @return The number of puzzles copied
+*/
+int threadMetrics::copySlowest(slowPuzzle *out) const
+{
+    while (true)
+    {
+        unsigned v = version.load(memory_order_acquire);
+        if (v & 1)
+        {
+            this_thread::yield();   // The owner is changing the list
+            continue;
+        }
+        int count = slowCount;
+        memcpy(out, slowest, sizeof(slowPuzzle) * count);
+        atomic_thread_fence(memory_order_acquire);
+        if (version.load(memory_order_relaxed) == v)
+            return count;
+    }
+}
+
+/** @brief Constructor for liveMetrics class
+ * @param path The snapshot file, or "-" for one line per snapshot on console
+ * @param console The stream for snapshot lines
+ * @param threads The number of solver threads
+ * @param slowest The number of slowest puzzles to keep
+ * @return None
+*/
+liveMetrics::liveMetrics(const string &path, ostream &console, int threads, int slowest)
+    : file(path), lines(console), blocks(max(threads, 1)), keep(min(max(slowest, 0), MaxSlowest)),
+      begin(chrono::steady_clock::now()), last(begin), lastSolves(0), stopping(false), failure(false)
+{
+    for (size_t t = 0; t < blocks.size(); t++)
+        blocks[t].keep = keep;
+    reporter = thread(&liveMetrics::run, this);
+}
+
+/** @brief Destructor for liveMetrics class
+ * @param None
+ * @return None
+*/
+liveMetrics::~liveMetrics()
+{
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    reporter.join();
+    report(true);
+}
+
+/** @brief Gets the counters of a solver thread
+ * @param thread The thread, 0 to threads - 1
+ * @return The counters
+*/
+threadMetrics &liveMetrics::forThread(int thread)
+{
+    return blocks[thread];
+}
+
+/** @brief Checks for a failed snapshot
+ * @param None
+ * @return True if a snapshot file could not be written
+*/
+bool liveMetrics::failed() const
+{
+    lock_guard<mutex> guard(lock);
+    return failure;
+}
+
+/** @brief Merges the counters of every thread and prints them
+ * @param out The stream to print to
+ * @param full True for every field and the histograms; false for one line
+ * @param withSlowest True to list the slowest puzzles after them
+ * @return None
+*/
+void liveMetrics::snapshot(ostream &out, bool full, bool withSlowest)
+{
+    long solves = 0, solved = 0, calls = 0, longest = 0, mostCalls = 0;
+    vector<long> latency(HistogramBuckets, 0), nodes(HistogramBuckets, 0);
+    vector<slowPuzzle> slowest;
+    slowPuzzle copy[MaxSlowest];
+    for (size_t t = 0; t < blocks.size(); t++)
+    {
+        const threadMetrics &m = blocks[t];
+        solves += m.solves.load(memory_order_relaxed);
+        solved += m.solved.load(memory_order_relaxed);
+        calls += m.calls.load(memory_order_relaxed);
+        longest = max(longest, m.longest.load(memory_order_relaxed));
+        mostCalls = max(mostCalls, m.mostCalls.load(memory_order_relaxed));
+        m.latency.addTo(&latency[0]);
+        m.nodes.addTo(&nodes[0]);
+        if (withSlowest)
+        {
+            int count = m.copySlowest(copy);
+            slowest.insert(slowest.end(), copy, copy + count);
+        }
+    }
+
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    double elapsed = chrono::duration<double>(now - begin).count();
+    double interval = chrono::duration<double>(now - last).count();
+    double rate = interval > 0 ? (solves - lastSolves) / interval : 0;  // Since the last snapshot
+    last = now;
+    lastSolves = solves;
+
+    const double fractions[] = {0.5, 0.9, 0.99, 0.999};
+    const char *names[] = {"p50", "p90", "p99", "p999"};
+    const char *separator = full ? " " : "=";
+    out << (full ? "elapsed " : "metrics elapsed=") << elapsed << (full ? "\n" : " ");
+    out << "puzzles" << separator << solves << (full ? "\n" : " ");
+    out << "solved" << separator << solved << (full ? "\n" : " ");
+    out << "calls" << separator << calls << (full ? "\n" : " ");
+    out << "rate" << separator << rate << (full ? "\n" : " ");
+    out << "latency_us";
+    for (int k = 0; k < 4; k++)
+        out << " " << names[k] << separator << logHistogram::percentile(&latency[0], fractions[k]) / 1000.0;
+    out << " max" << separator << longest / 1000.0 << (full ? "\n" : " ");
+    out << "nodes";
+    for (int k = 0; k < 4; k++)
+        out << " " << names[k] << separator << logHistogram::percentile(&nodes[0], fractions[k]);
+    out << " max" << separator << mostCalls << endl;
+
+    for (int b = 0; full && b < HistogramBuckets; b++)
+        if (latency[b] > 0)
+            out << "latency_ns_bucket " << logHistogram::bucketLow(b) << " " << latency[b] << "\n";
+    for (int b = 0; full && b < HistogramBuckets; b++)
+        if (nodes[b] > 0)
+            out << "nodes_bucket " << logHistogram::bucketLow(b) << " " << nodes[b] << "\n";
+
+    sort(slowest.begin(), slowest.end(),
+         [](const slowPuzzle &x, const slowPuzzle &y) { return x.nanoseconds > y.nanoseconds; });
+    for (int k = 0; k < (int)slowest.size() && k < keep; k++)
+    {
+        out << "slow " << slowest[k].puzzle << " " << slowest[k].nanoseconds / 1000.0 << " " << slowest[k].calls
+            << " ";
+        out.write(slowest[k].cells, CellCount);
+        out << "\n";
+    }
+    out.flush();
+}
+
+/** @brief Writes a snapshot where it was asked for
+ * @param last True for the snapshot at the end of the run
+ * @return None
+*/
+void liveMetrics::report(bool last)
+{
+    if (file == "-")
+    {
+        snapshot(lines, false, last);   // The slowest puzzles are listed once, at the end
+        return;
+    }
+
+    string temp = file + ".tmp";    // Readers see the old snapshot or the new one
+    bool ok;
+    {
+        ofstream fout(temp.c_str());
+        snapshot(fout, true, true);
+        ok = (bool)fout;
+    }
+    ok = ok && rename(temp.c_str(), file.c_str()) == 0;
+    lock_guard<mutex> guard(lock);
+    failure |= !ok;
+}
+
+/** @brief Writes snapshots until the run ends
+ * @param None
+ * @return None
+*/
+void liveMetrics::run()
+{
+    unique_lock<mutex> guard(lock);
+    while (!wake.wait_for(guard, chrono::duration<double>(MetricsSeconds), [this]() { return stopping; }))
+    {
+        guard.unlock();
+        report(false);
+        guard.lock();
+    }
+}
@@ -0,0 +1,135 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef LIVE_METRICS
+#define LIVE_METRICS
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "board.h"
+using namespace std;
+
+// Live metrics for long runs. Every solver thread owns a block of counters
+// and histograms that only it writes, with plain relaxed stores, so a
+// solve is recorded in a few nanoseconds without any shared cache line. A
+// reporter thread reads the blocks every few seconds, merges them and
+// writes a snapshot.
+
+const double MetricsSeconds = 1.0;  // Time between snapshots
+const int HistogramSubBits = 3;     // Sub-buckets per power of two: 1 << HistogramSubBits
+const int HistogramBuckets = (64 - HistogramSubBits + 1) << HistogramSubBits;
+const int MaxSlowest = 64;          // Slowest puzzles a run can keep
+
+// Counts of values in log-spaced buckets. Values below 1 << HistogramSubBits
+// have a bucket each; above that, each power of two is cut into
+// 1 << HistogramSubBits equal buckets, so a bucket is within 12.5% of any
+// value in it. Only one thread may record.
+class logHistogram
+{
+public:
+    logHistogram();
+
+    void record(unsigned long value);
+
+    void addTo(long *counts) const;
+    // adds the bucket counts to HistogramBuckets totals
+
+    static int bucketOf(unsigned long value);
+    static unsigned long bucketLow(int bucket);
+    // smallest value in a bucket
+
+    static unsigned long percentile(const long *counts, double fraction);
+    // smallest value of the bucket holding the given fraction of the
+    // counted values, 0 if there are none
+
+private:
+    atomic<long> counts[HistogramBuckets];
+};
+
+// A puzzle among the slowest seen
+struct slowPuzzle
+{
+    long puzzle;        // Position in the input
+    long nanoseconds;
+    long calls;
+    char cells[CellCount];
+};
+
+// The counters of one solver thread. Padding at both ends keeps them off
+// the cache lines of the blocks next to them
+struct threadMetrics
+{
+    char before[CacheLine];
+    atomic<long> solves;
+    atomic<long> solved;
+    atomic<long> calls;     // Recursive calls over the solved boards
+    atomic<long> longest;   // Longest solve, in nanoseconds
+    atomic<long> mostCalls; // Most recursive calls in one solve
+    logHistogram latency;   // Nanoseconds per solve
+    logHistogram nodes;     // Recursive calls per solve
+
+    // The thread's slowest puzzles, changed under a sequence lock: the
+    // version is odd while the list is being written
+    atomic<unsigned> version;
+    int keep;           // Puzzles to keep, at most MaxSlowest
+    int slowCount;
+    long threshold;     // Time a solve must beat to enter a full list
+    slowPuzzle slowest[MaxSlowest];
+    char after[CacheLine];
+
+    threadMetrics();
+
+    void record(long puzzle, const char *cells, long nanoseconds, long calls, bool isSolved);
+    // counts one solve. only the owning thread may call it
+
+    int copySlowest(slowPuzzle *out) const;
+    // copies a consistent slowest list. returns its length
+};
+
+// The counters of a run and the thread that reports them
+class liveMetrics
+{
+public:
+    liveMetrics(const string &path, ostream &console, int threads, int slowest);
+    // reports every MetricsSeconds. a path of "-" prints one line per
+    // snapshot to console and, after the last, one slow line per slowest
+    // puzzle; any other path is rewritten with the full snapshot each
+    // time. threads blocks of counters are made, and each keeps its
+    // slowest puzzles, at most MaxSlowest
+
+    ~liveMetrics();
+    // writes a last snapshot and stops the reporter
+
+    threadMetrics &forThread(int thread);
+
+    bool failed() const;
+    // true if a snapshot file could not be written
+
+private:
+    string file;
+    ostream &lines;
+    vector<threadMetrics> blocks;
+    int keep;
+    chrono::steady_clock::time_point begin, last;
+    long lastSolves;
+    mutable mutex lock;
+    condition_variable wake;
+    bool stopping;
+    bool failure;
+    thread reporter;
+
+    void snapshot(ostream &out, bool full, bool withSlowest);
+    void report(bool last);
+    void run();
+
+    liveMetrics(const liveMetrics &);
+    liveMetrics &operator=(const liveMetrics &);
+};
+
+#endif  // LIVE_METRICS
@@ -0,0 +1,92 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <atomic>
+#include <thread>
+#include "minimal.h"
+#include "logic.h"
+#include "enumerate.h"
+#include "sat.h"
+using namespace std;
+
+/** @brief Checks whether a puzzle still has one solution without a clue
+ * @param puzzle The puzzle
+ * @param solution Its solution
+ * @param clue The clue to leave out
+ * @return True if every other solution is ruled out, i.e. the clue is redundant
+*/
+bool probeClue(const boardState &puzzle, const boardState &solution, int clue)
+{
+    satSolver &solver = threadSolver();
+    solver.reset();
+
+    bool consistent = true;
+    for (int cell = 0; cell < CellCount; cell++)
+        if (cell != clue && puzzle.cells[cell] != Blank)
+            consistent &= solver.addUnit(satSolver::makeLit(cell * MaxValue + puzzle.cells[cell] - MinValue, false));
+    consistent &= solver.addUnit(satSolver::makeLit(clue * MaxValue + solution.cells[clue] - MinValue, true));
+
+    return !(consistent && solver.solve()); // No solution with a different value here
+}
+
+/** @brief Finds the clues of a puzzle that can be removed
+ * @param cells The puzzle, BoardSize * BoardSize characters row by row
+ * @param numThreads The number of probe threads
+ * @param report Set to the result of every check
+ * @return True if the puzzle is unique and minimal, false otherwise
+*/
+bool checkMinimality(const char *cells, int numThreads, minimalityReport &report)
+{
+    memset(&report, 0, sizeof(report));
+    board b(SquareSize);
+    b.initialize(cells);
+    const boardState puzzle = b.getState();
+    report.clues = puzzle.filled;
+
+    if (hasDuplicates(puzzle) || !b.solveSAT())
+        return false;
+    report.solvable = true;
+    const boardState solution = b.getState();
+
+    report.unique = countSolutions(puzzle, 2, 1) == 1;
+    if (!report.unique)
+        return false;
+
+    vector<int> probes;
+    for (int clue = 0; clue < CellCount; clue++)
+    {
+        if (puzzle.cells[clue] == Blank)
+            continue;
+        boardState work = puzzle;
+        work.remove(clue);
+        propagateSingles(work, true);
+        if (work.cells[clue] == solution.cells[clue])   // The other clues force it
+        {
+            report.redundant[clue] = true;
+            report.implied++;
+        }
+        else
+            probes.push_back(clue);
+    }
+    report.searched = (int)probes.size();
+
+    atomic<size_t> next(0);
+    auto worker = [&]()
+    {
+        size_t k;
+        while ((k = next++) < probes.size())
+            report.redundant[probes[k]] = probeClue(puzzle, solution, probes[k]);   // One writer per clue
+    };
+
+    vector<thread> workers;
+    for (int t = 1; t < numThreads && t < (int)probes.size(); t++)
+        workers.push_back(thread(worker));
+    worker();   // The calling thread probes too
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+
+    for (int clue = 0; clue < CellCount; clue++)
+        if (report.redundant[clue])
+            report.redundantCount++;
+    return report.redundantCount == 0;
+}
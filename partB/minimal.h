@@ -0,0 +1,30 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef MINIMALITY_CHECK
+#define MINIMALITY_CHECK
+
+#include "board.h"
+
+// Outcome of a minimality check. A clue is redundant when the puzzle
+// still has exactly one solution without it
+struct minimalityReport
+{
+    bool solvable;
+    bool unique;
+    int clues;
+    int redundantCount;
+    bool redundant[CellCount];  // True for clues that can be removed
+    int implied;    // Clues shown redundant by singles alone
+    int searched;   // Clues that needed a SAT probe
+};
+
+bool checkMinimality(const char *cells, int numThreads, minimalityReport &report);
+// checks every clue of a puzzle given as BoardSize * BoardSize characters.
+// a clue is probed by solving the other clues with the clue's cell barred
+// from its value: no solution means the clue is redundant. clues that the
+// others force through naked and hidden singles are marked without a
+// probe. probes are shared among numThreads threads. returns true if the
+// puzzle is unique and no clue is redundant
+
+#endif  // MINIMALITY_CHECK
@@ -0,0 +1,180 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <cstring>
+#include "perfcount.h"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+const char *PerfEventNames[PerfEventCount] = { "task-clock-ns", "cycles", "instructions", "L1d-misses",
+                                               "LLC-misses", "branch-misses" };
+
+/** @brief Zeroes a sample
+ * @param None
+ * @return None
+*/
+void perfSample::clear()
+{
+    for (int e = 0; e < PerfEventCount; e++)
+    {
+        values[e] = 0;
+        valid[e] = false;
+        scaled[e] = false;
+    }
+}
+
+/** @brief Accumulates another sample into this one
+ * @param other The sample to add
+ * @return None
+*/
+void perfSample::add(const perfSample &other)
+{
+    for (int e = 0; e < PerfEventCount; e++)
+        if (other.valid[e])
+        {
+            values[e] += other.values[e];
+            valid[e] = true;
+            scaled[e] = scaled[e] || other.scaled[e];
+        }
+}
+
+/** @brief Prints the counted events on one line
+ * @param out The stream to print to
+ * @return None
+ * @note Estimated events are listed after them as scaled=name,name
+*/
+void perfSample::print(ostream &out) const
+{
+    bool any = false, anyScaled = false;
+    for (int e = 0; e < PerfEventCount; e++)
+        if (valid[e])
+        {
+            out << (any ? " " : "") << PerfEventNames[e] << "=" << values[e];
+            any = true;
+        }
+    for (int e = 0; e < PerfEventCount; e++)
+        if (valid[e] && scaled[e])
+        {
+            out << (anyScaled ? "," : " scaled=") << PerfEventNames[e];
+            anyScaled = true;
+        }
+    if (!any)
+        out << "unavailable";   // No event could be opened on this machine
+    out << endl;
+}
+
+#ifdef __linux__
+
+/** @brief Opens one counting event for the calling thread
+ * @param type The perf event type
+ * @param config The event within the type
+ * @return The file descriptor, or -1 if the event is not available
+*/
+int openEvent(unsigned type, unsigned long long config)
+{
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;    // User space only, allowed for unprivileged users
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+#endif  // __linux__
+
+/** @brief Constructor for perfCounters class
+ * @param None
+ * @return None
+*/
+perfCounters::perfCounters()
+{
+    for (int e = 0; e < PerfEventCount; e++)
+        fds[e] = -1;
+#ifdef __linux__
+    const unsigned long long l1Miss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    fds[PerfTaskClock] = openEvent(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK);
+    fds[PerfCycles] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    fds[PerfInstructions] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds[PerfL1Misses] = openEvent(PERF_TYPE_HW_CACHE, l1Miss);
+    fds[PerfLLCMisses] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    fds[PerfBranchMisses] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+}
+
+/** @brief Destructor for perfCounters class
+ * @param None
+ * @return None
+*/
+perfCounters::~perfCounters()
+{
+#ifdef __linux__
+    for (int e = 0; e < PerfEventCount; e++)
+        if (fds[e] >= 0)
+            close(fds[e]);
+#endif
+}
+
+/** @brief Checks whether any event is being counted
+ * @param None
+ * @return True if at least one event is open
+*/
+bool perfCounters::available() const
+{
+    for (int e = 0; e < PerfEventCount; e++)
+        if (fds[e] >= 0)
+            return true;
+    return false;
+}
+
+/** @brief Zeroes and starts the counters
+ * @param None
+ * @return None
+*/
+void perfCounters::start()
+{
+#ifdef __linux__
+    for (int e = 0; e < PerfEventCount; e++)
+        if (fds[e] >= 0)
+        {
+            ioctl(fds[e], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds[e], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+}
+
+/** @brief Stops the counters and reads them
+ * @param sample The sample to fill in
+ * @return None
+*/
+void perfCounters::stop(perfSample &sample)
+{
+    sample.clear();
+#ifdef __linux__
+    for (int e = 0; e < PerfEventCount; e++)
+        if (fds[e] >= 0)
+            ioctl(fds[e], PERF_EVENT_IOC_DISABLE, 0);
+    for (int e = 0; e < PerfEventCount; e++)
+    {
+        unsigned long long counts[3];   // The count, then the time enabled and the time running
+        if (fds[e] < 0 || read(fds[e], counts, sizeof(counts)) != (ssize_t)sizeof(counts) || counts[2] == 0)
+            continue;   // Not read, or never on a counter
+        sample.values[e] = (long long)counts[0];
+        if (counts[2] < counts[1])
+        {
+            sample.values[e] = (long long)((double)counts[0] * counts[1] / counts[2]);
+            sample.scaled[e] = true;
+        }
+        sample.valid[e] = true;
+    }
+#endif
+}
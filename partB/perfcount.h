@@ -0,0 +1,56 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef PERF_COUNTERS
+#define PERF_COUNTERS
+
+#include <iostream>
+using namespace std;
+
+// Linux performance counters read around each solve. Events the kernel or
+// the machine does not provide are left out of the reports, so the program
+// runs the same way when no counter is available at all.
+
+enum perfEvent { PerfTaskClock, PerfCycles, PerfInstructions, PerfL1Misses, PerfLLCMisses,
+                 PerfBranchMisses, PerfEventCount };
+
+// Counter values for one solve or an accumulation of solves
+struct perfSample
+{
+    long long values[PerfEventCount];
+    bool valid[PerfEventCount]; // False for events that could not be counted
+    bool scaled[PerfEventCount];    // True for events that shared the counters and were estimated
+
+    void clear();
+    void add(const perfSample &other);
+    void print(ostream &out) const;
+};
+
+class perfCounters
+{
+public:
+    perfCounters();
+    // opens the events for the calling thread
+
+    ~perfCounters();
+
+    bool available() const;
+    // true if at least one event could be opened
+
+    void start();
+    // zeroes and starts the counters
+
+    void stop(perfSample &sample);
+    // stops the counters and reads them into sample. an event the kernel
+    // counted for only part of the time, because more events were open
+    // than the machine has counters, is scaled up to the whole time and
+    // marked as scaled
+
+private:
+    int fds[PerfEventCount];    // -1 for events that could not be opened
+
+    perfCounters(const perfCounters &);
+    perfCounters &operator=(const perfCounters &);
+};
+
+#endif  // PERF_COUNTERS
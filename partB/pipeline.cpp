@@ -0,0 +1,423 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "pipeline.h"
+#include "ring.h"
+#include "schedule.h"
+#include "inputcheck.h"
+#include "alloccount.h"
+#include "topology.h"
+using namespace std;
+
+// A batch of parsed puzzles handed from the reader to the solvers
+struct puzzleBatch
+{
+    int count;  // Number of puzzles in the batch
+    long index[PipelineBatchSize];  // Position of each puzzle in the input
+    bool split[PipelineBatchSize];  // True to split the search across the solvers
+    int length[PipelineBatchSize];  // Characters in each record
+    long windowEnd;     // Puzzles read up to the end of the batch's window
+    long endPosition;   // Source position at the end of the window
+    char cells[PipelineBatchSize][CellCount];
+};
+
+// The printed results of one batch, handed from a solver to the writer
+struct resultBatch
+{
+    int count;
+    long index[PipelineBatchSize];
+    string text[PipelineBatchSize];
+    runStats stats[PipelineBatchSize];  // Totals for each puzzle
+    long windowEnd;
+    long endPosition;
+};
+
+// Destroys and frees a queue made by newInputQueue
+struct inputQueueDelete
+{
+    void operator()(ringQueue<puzzleBatch> *queue) const
+    {
+        queue->~ringQueue<puzzleBatch>();
+        free(queue);
+    }
+};
+
+// The reader's queues, one per memory node the solvers use
+typedef vector<unique_ptr<ringQueue<puzzleBatch>, inputQueueDelete> > inputQueues;
+
+/** @brief Makes an input queue on the heap
+ * @param None
+ * @return The queue, to be freed by inputQueueDelete
+ * @note Plain new does not honour the queue's cache-line alignment before C++17
+*/
+ringQueue<puzzleBatch> *newInputQueue()
+{
+    void *memory = NULL;
+    if (posix_memalign(&memory, alignof(ringQueue<puzzleBatch>), sizeof(ringQueue<puzzleBatch>)) != 0)
+        throw bad_alloc();
+    try
+    {
+        return new (memory) ringQueue<puzzleBatch>(PipelineQueueSlots);
+    }
+    catch (...)
+    {
+        free(memory);
+        throw;
+    }
+}
+
+// A result waiting for the results before it
+struct pendingResult
+{
+    string text;
+    runStats stats;
+};
+
+/** @brief Parses puzzles a window at a time and hands them out costliest first
+ * @param source The puzzles to read
+ * @param engine The engine the solvers use
+ * @param canSplit True if expensive searches may be split across the solvers
+ * @param first The position in the input of the first puzzle read
+ * @param inputs The queues feeding the solvers, which take batches in turn
+ * @return None
+*/
+void readerStage(puzzleSource &source, engineType engine, bool canSplit, long first, inputQueues &inputs)
+{
+    vector<char> cells(ScheduleWindow * CellCount);
+    vector<double> cost(ScheduleWindow);
+    vector<int> length(ScheduleWindow);
+    inputReport report;
+    vector<int> order(ScheduleWindow);
+    board b(SquareSize);
+    puzzleBatch batch;
+    long read = first;
+    int count;
+    size_t turn = 0;    // Queue the next batch goes to
+    auto handOut = [&]() {
+        inputs[turn++ % inputs.size()]->push(batch);
+        batch.count = 0;
+    };
+
+    do
+    {
+        for (count = 0; count < ScheduleWindow && source.next(&cells[count * CellCount]); count++)
+            length[count] = source.recordLength();
+        long endPosition = source.position();
+
+        for (int p = 0; p < count; p++)
+        {
+            cost[p] = 0;    // The solver reports a bad record
+            if (checkPuzzle(&cells[p * CellCount], length[p], report))
+            {
+                b.initialize(&cells[p * CellCount]);
+                cost[p] = estimateCost(b.getState(), engine);
+            }
+            order[p] = p;
+        }
+        stable_sort(order.begin(), order.begin() + count, [&](int x, int y) { return cost[x] > cost[y]; });
+
+        batch.count = 0;
+        batch.windowEnd = read + count;
+        batch.endPosition = endPosition;
+        for (int k = 0; k < count; k++)
+        {
+            int p = order[k];
+            bool split = canSplit && cost[p] >= SplitCost;
+            if (split && batch.count > 0)   // A split puzzle goes alone
+                handOut();
+            batch.index[batch.count] = read + p;
+            batch.split[batch.count] = split;
+            batch.length[batch.count] = length[p];
+            memcpy(batch.cells[batch.count], &cells[p * CellCount], CellCount);
+            if (++batch.count == PipelineBatchSize || split)
+                handOut();
+        }
+        if (batch.count > 0)
+            handOut();  // Hands off the last partial batch of the window
+        read += count;
+    } while (count == ScheduleWindow);
+    for (size_t q = 0; q < inputs.size(); q++)
+        inputs[q]->close();
+}
+
+/** @brief Takes the next batch, from the solver's own queue if it has one
+ * @param inputs The queues from the reader
+ * @param home The queue on the solver's memory node
+ * @param batch Set to the batch
+ * @return False once every queue is closed and drained
+*/
+bool takeBatch(inputQueues &inputs, int home, puzzleBatch &batch)
+{
+    size_t count = inputs.size();
+    while (true)
+    {
+        bool closed = inputs[count - 1]->isClosed();    // Closed last, so every push is visible
+        for (size_t k = 0; k < count; k++)
+            if (inputs[(home + k) % count]->tryPop(batch))
+                return true;    // Other nodes' queues are taken from only when the own one is empty
+        if (closed)
+            return false;
+        this_thread::yield();
+    }
+}
+
+/** @brief Solves batches of puzzles and prints the results into text
+ * @param engine The engine to solve with
+ * @param profile True to read performance counters around each solve
+ * @param numThreads The number of solver threads
+ * @param pool The split searches shared by the solvers
+ * @param metrics This thread's live counters, or NULL
+ * @param cpu The processor to pin the thread to, or -1
+ * @param inputs The queues of parsed batches
+ * @param home The queue on this thread's memory node
+ * @param output The queue feeding the writer
+ * @return None
+*/
+void solverStage(engineType engine, bool profile, int numThreads, splitPool &pool, threadMetrics *metrics, int cpu,
+                 inputQueues &inputs, int home, ringQueue<resultBatch> &output)
+{
+    if (cpu >= 0)
+        pinThread(cpu);     // Before any state is built, so it is built on the local node
+    board b(SquareSize);    // Each solver owns its board
+    board::prepare(engine);
+    splitSearch split;
+    perfCounters counters;  // Counts this thread only
+    perfSample sample;
+    puzzleBatch batch;
+    ostringstream text;
+    inputReport report;
+
+    while (true)
+    {
+        while (pool.help())
+            ;   // Split searches come before new batches
+        pool.enter();
+        if (!takeBatch(inputs, home, batch))
+        {
+            pool.leave();
+            break;
+        }
+
+        resultBatch result;
+        result.count = batch.count;
+        result.windowEnd = batch.windowEnd;
+        result.endPosition = batch.endPosition;
+
+        for (int p = 0; p < batch.count; p++)
+        {
+            runStats &stats = result.stats[p];
+            stats.clear();
+            stats.puzzles = 1;
+            result.index[p] = batch.index[p];
+            text.str("");
+            if (!checkPuzzle(batch.cells[p], batch.length[p], report))
+            {
+                printIssues(text, batch.index[p], report);  // Rejected before any search
+                text << "Sudoku board is not solved." << endl;
+                result.text[p] = text.str();
+                continue;
+            }
+            try
+            {
+                b.initialize(batch.cells[p]);
+                b.print(text);
+                b.resetCallCount();
+                long allocations = threadAllocations();
+                chrono::steady_clock::time_point begin;
+                if (metrics != NULL)
+                    begin = chrono::steady_clock::now();
+                if (profile)
+                    counters.start();
+                long calls;
+                if (batch.split[p])
+                {
+                    split.start(b.getState(), SplitTasksPerThread * numThreads);
+                    pool.run(split);
+                    if (split.solved())
+                        b.setState(split.getState());
+                    calls = split.getCallCount();   // Same count as solving it here
+                }
+                else
+                {
+                    b.solve(engine);
+                    calls = b.getCallCount();
+                }
+                if (profile)
+                    counters.stop(sample);
+                if (metrics != NULL)
+                {
+                    chrono::nanoseconds elapsed = chrono::steady_clock::now() - begin;
+                    metrics->record(batch.index[p], batch.cells[p], (long)elapsed.count(), calls, b.isSolved());
+                }
+                allocations = threadAllocations() - allocations;
+                stats.allocations += allocations;
+                if (b.isSolved())   // Same report as the single threaded loop in main
+                {
+                    b.print(text);
+                    text << "Sudoku board is solved!" << endl;
+                    text << "Number of recursive calls: " << calls << endl;
+                    stats.solved++;
+                    stats.calls += calls;
+                }
+                else
+                {
+                    text << "Sudoku board is not solved." << endl;
+                }
+                if (allocationTracking())
+                    text << "Heap allocations during solve: " << allocations << endl;
+                if (profile)
+                {
+                    text << "Counters (" << engineName(engine) << "): ";
+                    sample.print(text);
+                    stats.counters.add(sample);
+                }
+            }
+            catch (baseException &ex)
+            {
+                text << ex.what() << endl;  // Reports the bad record and moves on
+            }
+            result.text[p] = text.str();
+        }
+
+        output.push(result);
+        pool.leave();
+    }
+
+    while (pool.active())   // Another solver may still split a puzzle
+        if (!pool.help())
+            this_thread::yield();
+}
+
+/** @brief Writes results in input order
+ * @param out The stream to write to
+ * @param output The queue of solved batches
+ * @param first The position in the input of the first puzzle
+ * @param totals Accumulates the totals of the written puzzles
+ * @param checkpoints Receives checkpoints, or NULL
+ * @return None
+*/
+void writerStage(ostream &out, ringQueue<resultBatch> &output, long first, runStats &totals,
+                 checkpointWriter *checkpoints)
+{
+    map<long, pendingResult> pending;   // Results that arrived ahead of their turn
+    map<long, long> windowEnds;     // Source position after each window, by puzzles read
+    long next = first;
+    long position = -1; // Source position covered by the written results
+    long written = 0;   // Output offset at that position
+    runStats covered;   // Totals at that position
+    covered.clear();
+    resultBatch result;
+
+    while (output.pop(result))
+    {
+        for (int p = 0; p < result.count; p++)
+        {
+            pendingResult &slot = pending[result.index[p]];
+            slot.text.swap(result.text[p]);
+            slot.stats = result.stats[p];
+        }
+        windowEnds[result.windowEnd] = result.endPosition;
+
+        map<long, pendingResult>::iterator it;
+        while ((it = pending.find(next)) != pending.end())
+        {
+            out << it->second.text;
+            totals.add(it->second.stats);
+            pending.erase(it);
+            next++;
+
+            map<long, long>::iterator end = windowEnds.find(next);
+            if (end != windowEnds.end())    // A whole window is written
+            {
+                position = end->second;
+                windowEnds.erase(end);
+                if (checkpoints != NULL)
+                {
+                    out.flush();
+                    written = (long)out.tellp();
+                    covered = totals;
+                }
+            }
+        }
+
+        if (checkpoints != NULL && position >= 0 && checkpoints->due())
+        {
+            checkpoint state = { position, written, covered };
+            checkpoints->submit(state);
+        }
+    }
+    out.flush();
+    if (checkpoints != NULL && position >= 0)
+    {
+        checkpoint state = { position, written, covered };
+        checkpoints->submit(state);
+    }
+}
+
+/** @brief Solves every puzzle from a source with a reader/solver/writer pipeline
+ * @param source The puzzles to solve
+ * @param out The stream to write to
+ * @param engine The engine to solve with
+ * @param numThreads The number of solver threads
+ * @param profile True to read performance counters around each solve
+ * @param totals Accumulates the totals
+ * @param checkpoints Receives checkpoints from the writer, or NULL
+ * @param metrics Live counters with a block per solver thread, or NULL
+ * @param pinning The processors to pin the solvers to, or NULL to leave them unpinned
+ * @return None
+*/
+void runPipeline(puzzleSource &source, ostream &out, engineType engine, int numThreads, bool profile,
+                 runStats &totals, checkpointWriter *checkpoints, liveMetrics *metrics, const cpuTopology *pinning)
+{
+    vector<int> cpus(numThreads, -1), homes(numThreads, 0);
+    vector<int> nodes, queueCpus;   // Nodes the solvers run on, and a solver processor on each
+    for (int t = 0; t < numThreads && pinning != NULL; t++)
+    {
+        const cpuPlace &place = pinning->slot(t);
+        cpus[t] = place.cpu;
+        homes[t] = (int)(find(nodes.begin(), nodes.end(), place.node) - nodes.begin());
+        if (homes[t] == (int)nodes.size())
+        {
+            nodes.push_back(place.node);
+            queueCpus.push_back(place.cpu);
+        }
+    }
+
+    inputQueues inputs(max(nodes.size(), (size_t)1));
+    if (nodes.empty())
+        inputs[0].reset(newInputQueue());
+    for (size_t q = 0; q < nodes.size(); q++)
+        thread([&inputs, &queueCpus, q]() {
+            pinThread(queueCpus[q]);    // The queue's slots are first written, and so placed, on its node
+            inputs[q].reset(newInputQueue());
+        }).join();
+    ringQueue<resultBatch> output(PipelineQueueSlots);
+
+    splitPool pool(numThreads);
+
+    long first = totals.puzzles;    // Puzzles already done by a resumed run
+
+    thread reader(readerStage, ref(source), engine, engine == BacktrackEngine && numThreads > 1, first, ref(inputs));
+    thread writer(writerStage, ref(out), ref(output), first, ref(totals), checkpoints);
+
+    vector<thread> solvers;
+    for (int t = 0; t < numThreads; t++)
+        solvers.push_back(thread(solverStage, engine, profile, numThreads, ref(pool),
+                                 metrics != NULL ? &metrics->forThread(t) : (threadMetrics *)NULL, cpus[t],
+                                 ref(inputs), homes[t], ref(output)));
+
+    reader.join();
+    for (size_t t = 0; t < solvers.size(); t++)
+        solvers[t].join();
+    output.close(); // Every solver is done, so the writer can drain and stop
+    writer.join();
+}
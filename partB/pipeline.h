@@ -0,0 +1,32 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef PIPELINE
+#define PIPELINE
+
+#include <iostream>
+#include "board.h"
+#include "checkpoint.h"
+#include "metrics.h"
+#include "source.h"
+#include "topology.h"
+using namespace std;
+
+const int PipelineBatchSize = 32;   // Puzzles per queue slot
+const int PipelineQueueSlots = 16;  // Slots in each ring buffer
+const int ScheduleWindow = PipelineBatchSize * PipelineQueueSlots;  // Puzzles read ahead and ordered by cost
+
+void runPipeline(puzzleSource &source, ostream &out, engineType engine, int numThreads, bool profile,
+                 runStats &totals, checkpointWriter *checkpoints, liveMetrics *metrics, const cpuTopology *pinning);
+// solves every puzzle of source, writing the results to out in input
+// order and adding to totals. puzzles are read ScheduleWindow at a time
+// and handed out costliest first; with more than one thread, backtracking
+// searches estimated at SplitCost or more are split across the solvers.
+// if checkpoints is not NULL, the writer thread submits a checkpoint when
+// one is due and after the last window. if metrics is not NULL, solver
+// thread t records every solve in metrics->forThread(t). if pinning is
+// not NULL, solver t runs on pinning->slot(t) and builds its state there,
+// and each memory node the solvers use gets its own input queue, which
+// its solvers drain before they take batches from other nodes
+
+#endif  // PIPELINE
@@ -0,0 +1,157 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef RING_QUEUE
+#define RING_QUEUE
+
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Bounded lock-free ring buffer connecting pipeline stages. Every slot
+// carries a sequence number, so producers and consumers only synchronize
+// on the slot they claim. Any number of threads may push or pop, which
+// covers both the reader -> solvers (one producer, many consumers) and the
+// solvers -> writer (many producers, one consumer) links.
+template <typename T>
+class ringQueue
+{
+public:
+    ringQueue(int capacity);
+    // constructor.
+    // Precondition: capacity is a power of two.
+    // Postcondition: an empty, open queue of capacity slots
+
+    bool tryPush(T &item);
+    // moves item into the queue. returns false if the queue is full
+
+    bool tryPop(T &item);
+    // moves the oldest item out of the queue. returns false if it is empty
+
+    void push(T &item);
+    // moves item into the queue, waiting while the queue is full
+
+    bool pop(T &item);
+    // moves the oldest item out of the queue, waiting while it is empty.
+    // returns false once the queue is closed and drained
+
+    void close();
+    // marks the end of the stream. no pushes may follow
+
+    bool isClosed() const;
+    // true once close has been called. pushes made before close are
+    // visible to a thread that sees it
+
+private:
+    struct slot
+    {
+        atomic<size_t> seq;
+        T value;
+    };
+
+    vector<slot> slots;
+    size_t mask;
+
+    // producer and consumer positions live on separate cache lines
+    alignas(64) atomic<size_t> enqueuePos;
+    alignas(64) atomic<size_t> dequeuePos;
+    alignas(64) atomic<bool> closed;
+};
+
+template <typename T>
+ringQueue<T>::ringQueue(int capacity) : slots(capacity), mask(capacity - 1), enqueuePos(0), dequeuePos(0), closed(false)
+{
+    for (size_t i = 0; i < slots.size(); i++)
+        slots[i].seq.store(i, memory_order_relaxed);
+}
+
+template <typename T>
+bool ringQueue<T>::tryPush(T &item)
+{
+    size_t pos = enqueuePos.load(memory_order_relaxed);
+    while (true)
+    {
+        slot &s = slots[pos & mask];
+        size_t seq = s.seq.load(memory_order_acquire);
+        long diff = (long)seq - (long)pos;
+
+        if (diff == 0)
+        {
+            // the slot is free for this lap; claim it
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+            {
+                s.value = move(item);
+                s.seq.store(pos + 1, memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+            return false;   // full
+        else
+            pos = enqueuePos.load(memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool ringQueue<T>::tryPop(T &item)
+{
+    size_t pos = dequeuePos.load(memory_order_relaxed);
+    while (true)
+    {
+        slot &s = slots[pos & mask];
+        size_t seq = s.seq.load(memory_order_acquire);
+        long diff = (long)seq - (long)(pos + 1);
+
+        if (diff == 0)
+        {
+            // the slot holds an item for this lap; claim it
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+            {
+                item = move(s.value);
+                s.seq.store(pos + mask + 1, memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+            return false;   // empty
+        else
+            pos = dequeuePos.load(memory_order_relaxed);
+    }
+}
+
+template <typename T>
+void ringQueue<T>::push(T &item)
+{
+    while (!tryPush(item))
+        this_thread::yield();
+}
+
+template <typename T>
+bool ringQueue<T>::pop(T &item)
+{
+    while (!tryPop(item))
+    {
+        // check closed before the last attempt so a final push is not lost
+        if (closed.load(memory_order_acquire))
+            return tryPop(item);
+        this_thread::yield();
+    }
+    return true;
+}
+
+template <typename T>
+void ringQueue<T>::close()
+{
+    closed.store(true, memory_order_release);
+}
+
+template <typename T>
+bool ringQueue<T>::isClosed() const
+{
+    return closed.load(memory_order_acquire);
+}
+
+#endif  // RING_QUEUE
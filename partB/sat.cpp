@@ -0,0 +1,690 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <algorithm>
+#include <cmath>
+#include "sat.h"
+using namespace std;
+
+const double VarDecay = 0.95;
+const double ClauseDecay = 0.999;
+const int RestartBase = 100;    // Conflicts in the first Luby restart interval
+const int ArenaReserve = 1 << 18;   // Literals reserved for learnt clauses
+const int LearntReserve = 1 << 15;  // Learnt clauses reserved beyond the originals
+const int WatchReserve = 64;        // Watch slots reserved per literal beyond the originals
+
+/** @brief Constructor for satSolver class
+ * @param numVars The number of variables in the formula
+ * @return None
+*/
+satSolver::satSolver(int numVars) : nVars(numVars), ok(true), numOriginal(0), numLearnts(0), maxLearnts(0),
+    watches(2 * numVars), assigns(numVars, -1), level(numVars, 0), reason(numVars, -1),
+    polarity(numVars, 1), seen(numVars, 0), qhead(0), activity(numVars, 0.0),
+    varInc(1.0), clauseInc(1.0f), heapIndex(numVars, -1), decisions(0), conflicts(0), propagations(0)
+{
+    trail.reserve(numVars);
+    trailLim.reserve(numVars);
+    heap.reserve(numVars);
+    learntClause.reserve(numVars);
+    analyzed.reserve(numVars);
+    for (int v = 0; v < nVars; v++)
+        heapInsert(v);  // Every variable starts out as a branching candidate
+}
+
+/** @brief Builds a literal
+ * @param var The variable
+ * @param negated True for the negative literal
+ * @return The encoded literal
+*/
+int satSolver::makeLit(int var, bool negated)
+{
+    return 2 * var + (negated ? 1 : 0);
+}
+
+/** @brief Gets the literals of a clause
+ * @param c The clause index
+ * @return A pointer to the first literal in the arena
+*/
+int *satSolver::lits(int c)
+{
+    return &arena[clauses[c].start];
+}
+
+/** @brief Gets the value of a literal
+ * @param lit The literal
+ * @return 1 if true, 0 if false, -1 if unassigned
+*/
+int satSolver::litValue(int lit) const
+{
+    int a = assigns[lit >> 1];
+    return a < 0 ? -1 : (a ^ (lit & 1));
+}
+
+/** @brief Gets the current decision level
+ * @param None
+ * @return The number of open decisions
+*/
+int satSolver::decisionLevel() const
+{
+    return (int)trailLim.size();
+}
+
+/** @brief Adds a clause to the formula
+ * @param lits The literals of the clause
+ * @return False if the formula became unsatisfiable, true otherwise
+*/
+bool satSolver::addClause(const vector<int> &lits)
+{
+    if (!ok)
+        return false;
+
+    vector<int> c;
+    for (size_t k = 0; k < lits.size(); k++)
+    {
+        int val = litValue(lits[k]);
+        if (val == 1 || find(c.begin(), c.end(), lits[k] ^ 1) != c.end())
+            return true;    // Clause is already satisfied or a tautology
+        if (val == 0 || find(c.begin(), c.end(), lits[k]) != c.end())
+            continue;   // Drops false and duplicate literals
+        c.push_back(lits[k]);
+    }
+
+    if (c.empty())
+        return ok = false;  // Empty clause, the formula is unsatisfiable
+
+    if (c.size() == 1)
+    {
+        enqueue(c[0], -1);  // Unit clauses are assigned directly at level 0
+        return true;
+    }
+
+    attachClause(storeClause(&c[0], (int)c.size(), false));
+    numOriginal++;
+    return true;
+}
+
+/** @brief Asserts a literal at decision level 0
+ * @param lit The literal
+ * @return False if the formula became unsatisfiable, true otherwise
+*/
+bool satSolver::addUnit(int lit)
+{
+    int val = litValue(lit);
+    if (val == 0)
+        return ok = false;  // Contradicts an earlier unit
+    if (val == -1)
+        enqueue(lit, -1);
+    return ok;
+}
+
+/** @brief Returns to the original clauses with nothing assigned
+ * @param None
+ * @return None
+*/
+void satSolver::reset()
+{
+    cancelUntil(0);
+    for (size_t t = 0; t < trail.size(); t++)
+    {
+        int v = trail[t] >> 1;
+        assigns[v] = -1;
+        reason[v] = -1;
+    }
+    trail.clear();
+    qhead = 0;
+    ok = true;
+
+    if (numOriginal < (int)clauses.size())  // Drops the learnt clauses
+    {
+        arena.resize(clauses[numOriginal].start);
+        clauses.resize(numOriginal);
+    }
+    numLearnts = 0;
+
+    // Propagation reorders literals inside clauses, which changes the watches.
+    // Restoring the added order makes every search independent of the last one
+    if (originalArena.size() != arena.size())
+        originalArena.assign(arena.begin(), arena.end());
+    else
+        copy(originalArena.begin(), originalArena.end(), arena.begin());
+
+    for (size_t w = 0; w < watches.size(); w++)
+        watches[w].clear();
+    for (int c = 0; c < numOriginal; c++)
+    {
+        clauses[c].activity = 0.0f;
+        attachClause(c);
+    }
+
+    // Sizes the work lists for learnt clauses once, so later searches stay off the heap
+    if (clauses.capacity() < (size_t)numOriginal + LearntReserve)
+    {
+        clauses.reserve(numOriginal + LearntReserve);
+        reduceActs.reserve(LearntReserve);
+        for (size_t w = 0; w < watches.size(); w++)
+            watches[w].reserve(watches[w].size() + WatchReserve);
+    }
+
+    heap.clear();
+    varInc = 1.0;
+    clauseInc = 1.0f;
+    for (int v = 0; v < nVars; v++)
+    {
+        activity[v] = 0.0;
+        polarity[v] = 1;
+        heapIndex[v] = -1;
+    }
+    for (int v = 0; v < nVars; v++)
+        heapInsert(v);  // Same branching order as a fresh solver
+}
+
+/** @brief Appends a clause to the arena
+ * @param first The first literal
+ * @param size The number of literals
+ * @param isLearnt True for a learnt clause
+ * @return The clause index
+*/
+int satSolver::storeClause(const int *first, int size, bool isLearnt)
+{
+    if (arena.capacity() == 0)
+        arena.reserve(ArenaReserve);
+    clauseData data;
+    data.start = (int)arena.size();
+    data.size = size;
+    data.learnt = isLearnt;
+    data.activity = 0.0f;
+    arena.insert(arena.end(), first, first + size);
+    clauses.push_back(data);
+    return (int)clauses.size() - 1;
+}
+
+/** @brief Watches the first two literals of a clause
+ * @param c The clause index
+ * @return None
+*/
+void satSolver::attachClause(int c)
+{
+    int *cl = lits(c);
+    for (int w = 0; w < 2; w++)
+    {
+        watches[cl[w]].push_back(c);
+    }
+}
+
+/** @brief Assigns a literal true
+ * @param lit The literal
+ * @param from The implying clause, or -1 for a decision
+ * @return None
+*/
+void satSolver::enqueue(int lit, int from)
+{
+    int v = lit >> 1;
+    assigns[v] = (lit & 1) ? 0 : 1;
+    level[v] = decisionLevel();
+    reason[v] = from;
+    trail.push_back(lit);
+}
+
+/** @brief Propagates all pending assignments using two watched literals
+ * @param None
+ * @return The index of a conflicting clause, or -1 if there is none
+*/
+int satSolver::propagate()
+{
+    while (qhead < (int)trail.size())
+    {
+        int falseLit = trail[qhead++] ^ 1;  // Literal that just became false
+        vector<int> &ws = watches[falseLit];
+        propagations++;
+
+        size_t i = 0, j = 0;
+        while (i < ws.size())
+        {
+            int ci = ws[i++];
+            int *c = lits(ci);
+            int size = clauses[ci].size;
+
+            if (c[0] == falseLit)   // Keeps the false watch in position 1
+                swap(c[0], c[1]);
+
+            if (litValue(c[0]) == 1)
+            {
+                ws[j++] = ci;   // Clause is satisfied by the other watch
+                continue;
+            }
+
+            bool moved = false;
+            for (int k = 2; k < size; k++)
+            {
+                if (litValue(c[k]) != 0)    // Finds a replacement watch
+                {
+                    swap(c[1], c[k]);
+                    watches[c[1]].push_back(ci);
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved)
+                continue;
+
+            ws[j++] = ci;
+            if (litValue(c[0]) == 0)    // Every literal is false
+            {
+                while (i < ws.size())
+                    ws[j++] = ws[i++];
+                ws.resize(j);
+                qhead = (int)trail.size();
+                return ci;
+            }
+            enqueue(c[0], ci);  // Clause is unit
+        }
+        ws.resize(j);
+    }
+
+    return -1;
+}
+
+/** @brief Derives a first-UIP clause from a conflict
+ * @param confl The conflicting clause
+ * @param outLearnt The learnt clause, asserting literal first
+ * @param outLevel The level to backjump to
+ * @return None
+*/
+void satSolver::analyze(int confl, vector<int> &outLearnt, int &outLevel)
+{
+    int pathC = 0;
+    int p = -1;
+    int index = (int)trail.size() - 1;
+    outLearnt.clear();
+    outLearnt.push_back(-1);    // Placeholder for the asserting literal
+
+    do
+    {
+        if (clauses[confl].learnt)
+            bumpClause(confl);
+
+        const int *c = lits(confl);
+        int size = clauses[confl].size;
+        for (int k = (p == -1 ? 0 : 1); k < size; k++)
+        {
+            int q = c[k];
+            int v = q >> 1;
+            if (!seen[v] && level[v] > 0)
+            {
+                bumpVar(v);
+                seen[v] = 1;
+                if (level[v] >= decisionLevel())
+                    pathC++;    // Still to be resolved at the current level
+                else
+                    outLearnt.push_back(q);
+            }
+        }
+
+        while (!seen[trail[index] >> 1])    // Next marked literal on the trail
+            index--;
+        p = trail[index--];
+        confl = reason[p >> 1];
+        seen[p >> 1] = 0;
+        pathC--;
+    } while (pathC > 0);
+
+    outLearnt[0] = p ^ 1;
+
+    // Drops literals that are implied by the rest of the clause
+    analyzed.assign(outLearnt.begin(), outLearnt.end());
+    size_t j = 1;
+    for (size_t i = 1; i < outLearnt.size(); i++)
+        if (reason[outLearnt[i] >> 1] == -1 || !litRedundant(outLearnt[i]))
+            outLearnt[j++] = outLearnt[i];
+    outLearnt.resize(j);
+
+    for (size_t i = 0; i < analyzed.size(); i++)
+        seen[analyzed[i] >> 1] = 0;
+
+    outLevel = 0;
+    if (outLearnt.size() > 1)
+    {
+        size_t maxI = 1;
+        for (size_t i = 2; i < outLearnt.size(); i++)
+            if (level[outLearnt[i] >> 1] > level[outLearnt[maxI] >> 1])
+                maxI = i;
+        swap(outLearnt[1], outLearnt[maxI]);    // Second watch at the backjump level
+        outLevel = level[outLearnt[1] >> 1];
+    }
+}
+
+/** @brief Checks whether a learnt literal is implied by the others
+ * @param lit The literal to check
+ * @return True if every antecedent is already in the clause or fixed
+*/
+bool satSolver::litRedundant(int lit)
+{
+    int r = reason[lit >> 1];
+    const int *c = lits(r);
+    for (int k = 1; k < clauses[r].size; k++)
+    {
+        int v = c[k] >> 1;
+        if (!seen[v] && level[v] > 0)
+            return false;
+    }
+    return true;
+}
+
+/** @brief Backtracks to a decision level
+ * @param lvl The level to keep
+ * @return None
+*/
+void satSolver::cancelUntil(int lvl)
+{
+    if (decisionLevel() <= lvl)
+        return;
+
+    for (int c = (int)trail.size() - 1; c >= trailLim[lvl]; c--)
+    {
+        int v = trail[c] >> 1;
+        polarity[v] = trail[c] & 1; // Phase saving
+        assigns[v] = -1;
+        reason[v] = -1;
+        if (heapIndex[v] < 0)
+            heapInsert(v);
+    }
+    trail.resize(trailLim[lvl]);
+    trailLim.resize(lvl);
+    qhead = (int)trail.size();
+}
+
+/** @brief Picks the unassigned variable with the highest activity
+ * @param None
+ * @return The literal to branch on, or -1 if every variable is assigned
+*/
+int satSolver::pickBranchLit()
+{
+    while (!heap.empty())
+    {
+        int v = heapRemoveMax();
+        if (assigns[v] < 0)
+            return makeLit(v, polarity[v] != 0);
+    }
+    return -1;
+}
+
+/** @brief Removes the less active half of the learnt clauses
+ * @param None
+ * @return None
+ * @note Only called at decision level 0 after propagation. Original
+ *       clauses are never changed, so reset() can return to them
+*/
+void satSolver::reduceDB()
+{
+    reduceActs.clear();
+    for (size_t c = numOriginal; c < clauses.size(); c++)
+        if (clauses[c].size > 2)
+            reduceActs.push_back(clauses[c].activity);
+    float cutoff = 0.0f;
+    if (!reduceActs.empty())
+    {
+        nth_element(reduceActs.begin(), reduceActs.begin() + reduceActs.size() / 2, reduceActs.end());
+        cutoff = reduceActs[reduceActs.size() / 2];
+    }
+
+    size_t j = numOriginal;
+    int end = numOriginal < (int)clauses.size() ? clauses[numOriginal].start : (int)arena.size();
+    numLearnts = 0;
+    for (size_t c = numOriginal; c < clauses.size(); c++)
+    {
+        clauseData data = clauses[c];
+        if (data.size > 2 && data.activity < cutoff)
+            continue;   // Inactive learnt clause
+
+        for (int k = 0; k < data.size; k++)
+            arena[end + k] = arena[data.start + k];    // Compacts the arena
+        data.start = end;
+        end += data.size;
+        clauses[j++] = data;
+        numLearnts++;
+    }
+    clauses.resize(j);
+    arena.resize(end);
+
+    for (size_t w = 0; w < watches.size(); w++)
+        watches[w].clear();
+    for (size_t c = 0; c < clauses.size(); c++)
+    {
+        int *cl = lits((int)c);
+        int front = 0;
+        for (int k = 0; k < clauses[c].size && front < 2; k++)
+            if (litValue(cl[k]) != 0)
+                swap(cl[front++], cl[k]);   // Watches literals that are not fixed false
+        attachClause((int)c);
+    }
+    for (size_t t = 0; t < trail.size(); t++)
+        reason[trail[t] >> 1] = -1; // Level 0 reasons are never analyzed
+}
+
+/** @brief Bumps the activity of a variable
+ * @param var The variable
+ * @return None
+*/
+void satSolver::bumpVar(int var)
+{
+    if ((activity[var] += varInc) > 1e100)
+    {
+        for (int v = 0; v < nVars; v++)
+            activity[v] *= 1e-100;  // Rescales to avoid overflow
+        varInc *= 1e-100;
+    }
+    if (heapIndex[var] >= 0)
+        heapUp(heapIndex[var]);
+}
+
+/** @brief Bumps the activity of a learnt clause
+ * @param c The clause index
+ * @return None
+*/
+void satSolver::bumpClause(int c)
+{
+    if ((clauses[c].activity += clauseInc) > 1e20f)
+    {
+        for (size_t k = 0; k < clauses.size(); k++)
+            clauses[k].activity *= 1e-20f;
+        clauseInc *= 1e-20f;
+    }
+}
+
+/** @brief Inserts a variable into the activity heap
+ * @param var The variable
+ * @return None
+*/
+void satSolver::heapInsert(int var)
+{
+    heapIndex[var] = (int)heap.size();
+    heap.push_back(var);
+    heapUp(heapIndex[var]);
+}
+
+/** @brief Moves a heap entry towards the root
+ * @param pos The heap position
+ * @return None
+*/
+void satSolver::heapUp(int pos)
+{
+    int var = heap[pos];
+    while (pos > 0)
+    {
+        int parent = (pos - 1) / 2;
+        if (activity[heap[parent]] >= activity[var])
+            break;
+        heap[pos] = heap[parent];
+        heapIndex[heap[pos]] = pos;
+        pos = parent;
+    }
+    heap[pos] = var;
+    heapIndex[var] = pos;
+}
+
+/** @brief Moves a heap entry towards the leaves
+ * @param pos The heap position
+ * @return None
+*/
+void satSolver::heapDown(int pos)
+{
+    int var = heap[pos];
+    int size = (int)heap.size();
+    while (2 * pos + 1 < size)
+    {
+        int child = 2 * pos + 1;
+        if (child + 1 < size && activity[heap[child + 1]] > activity[heap[child]])
+            child++;
+        if (activity[heap[child]] <= activity[var])
+            break;
+        heap[pos] = heap[child];
+        heapIndex[heap[pos]] = pos;
+        pos = child;
+    }
+    heap[pos] = var;
+    heapIndex[var] = pos;
+}
+
+/** @brief Removes the most active variable from the heap
+ * @param None
+ * @return The variable
+*/
+int satSolver::heapRemoveMax()
+{
+    int top = heap[0];
+    heap[0] = heap.back();
+    heapIndex[heap[0]] = 0;
+    heap.pop_back();
+    heapIndex[top] = -1;
+    if (!heap.empty())
+        heapDown(0);
+    return top;
+}
+
+/** @brief Computes the Luby restart sequence
+ * @param y The base of the sequence
+ * @param x The index in the sequence
+ * @return y raised to the x-th Luby exponent
+*/
+double satSolver::luby(double y, int x)
+{
+    int size = 1, seq = 0;
+    while (size < x + 1)
+    {
+        seq++;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != x)
+    {
+        size = (size - 1) >> 1;
+        seq--;
+        x = x % size;
+    }
+    return pow(y, seq);
+}
+
+/** @brief Runs the CDCL search
+ * @param None
+ * @return True if a model was found, false if the formula is unsatisfiable
+*/
+bool satSolver::solve()
+{
+    decisions = conflicts = propagations = 0;
+    if (!ok || propagate() != -1)
+        return ok = false;
+
+    maxLearnts = clauses.size() / 3.0 + 100;
+    int restarts = 0;
+    long restartLimit = (long)(luby(2, restarts) * RestartBase);
+    long sinceRestart = 0;
+
+    while (true)
+    {
+        int confl = propagate();
+        if (confl != -1)
+        {
+            conflicts++;
+            sinceRestart++;
+            if (decisionLevel() == 0)
+                return ok = false;  // Conflict without decisions
+
+            int btLevel;
+            analyze(confl, learntClause, btLevel);
+            cancelUntil(btLevel);
+
+            if (learntClause.size() == 1)
+                enqueue(learntClause[0], -1);
+            else
+            {
+                int c = storeClause(&learntClause[0], (int)learntClause.size(), true);
+                numLearnts++;
+                attachClause(c);
+                bumpClause(c);
+                enqueue(learntClause[0], c);
+            }
+
+            varInc /= VarDecay;
+            clauseInc /= (float)ClauseDecay;
+        }
+        else
+        {
+            if (sinceRestart >= restartLimit && decisionLevel() > 0)
+            {
+                cancelUntil(0); // Restarts the search, keeping learnt clauses
+                restarts++;
+                restartLimit = (long)(luby(2, restarts) * RestartBase);
+                sinceRestart = 0;
+                if (numLearnts > maxLearnts)
+                {
+                    reduceDB();
+                    maxLearnts *= 1.1;
+                }
+                continue;
+            }
+
+            int lit = pickBranchLit();
+            if (lit == -1)
+                return true;    // Every variable is assigned
+
+            decisions++;
+            trailLim.push_back((int)trail.size());
+            enqueue(lit, -1);
+        }
+    }
+}
+
+/** @brief Gets the value of a variable in the model
+ * @param var The variable
+ * @return True if the variable is assigned true
+*/
+bool satSolver::modelValue(int var) const
+{
+    return assigns[var] == 1;
+}
+
+/** @brief Gets the number of decisions made by the last search
+ * @param None
+ * @return The decision count
+*/
+long satSolver::getDecisions() const
+{
+    return decisions;
+}
+
+/** @brief Gets the number of conflicts in the last search
+ * @param None
+ * @return The conflict count
+*/
+long satSolver::getConflicts() const
+{
+    return conflicts;
+}
+
+/** @brief Gets the number of propagated literals in the last search
+ * @param None
+ * @return The propagation count
+*/
+long satSolver::getPropagations() const
+{
+    return propagations;
+}
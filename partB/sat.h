@@ -0,0 +1,117 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef SAT_SOLVER
+#define SAT_SOLVER
+
+#include <vector>
+
+using namespace std;
+
+// A self-contained CDCL SAT solver used as an alternative engine for the
+// hardest boards. Literals are encoded as 2 * var + sign, where sign 1 means
+// the variable is negated. Variables are numbered from 0.
+//
+// Clauses live back to back in one arena and every work list keeps its
+// capacity across reset(), so once a solver has been built and warmed up,
+// solving another instance of the same formula does not touch the heap.
+class satSolver
+{
+public:
+    satSolver(int numVars);
+    // Postcondition: an empty formula over numVars variables
+
+    static int makeLit(int var, bool negated);
+    // returns the encoded literal for var (negated if requested)
+
+    bool addClause(const vector<int> &lits);
+    // adds a clause at decision level 0. returns false once the
+    // formula is known to be unsatisfiable. clauses of two or more
+    // literals must be added before solve() or right after reset()
+
+    bool addUnit(int lit);
+    // asserts lit at decision level 0 without allocating. returns
+    // false if lit is already false
+
+    void reset();
+    // forgets learnt clauses, assignments and activities. clauses of
+    // two or more literals added with addClause are kept; unit clauses
+    // must be added again
+
+    bool solve();
+    // runs the search. returns true and leaves a full model in place
+    // if the formula is satisfiable, false otherwise
+
+    bool modelValue(int var) const;
+    // value of var in the model found by solve()
+
+    long getDecisions() const;
+    long getConflicts() const;
+    long getPropagations() const;
+    // search statistics for the last call to solve()
+
+private:
+    struct clauseData
+    {
+        int start;      // Offset of the first literal in the arena
+        int size;       // Number of literals
+        bool learnt;    // True for clauses derived by conflict analysis
+        float activity; // Bumped when the clause takes part in a conflict
+    };
+
+    int nVars;
+    bool ok;    // false once an empty clause has been derived
+
+    vector<int> arena;                  // Literals of every clause
+    vector<int> originalArena;          // Original clauses in their added literal order
+    vector<clauseData> clauses;         // Original clauses first, then learnt ones
+    int numOriginal;                    // Number of original clauses
+    int numLearnts;
+    double maxLearnts;
+
+    vector<vector<int> > watches;   // watches[lit] lists clauses watching lit
+    vector<signed char> assigns;    // -1 unassigned, 0 false, 1 true
+    vector<int> level;              // decision level of each variable
+    vector<int> reason;             // implying clause, or -1 for decisions
+    vector<char> polarity;          // saved phase (1 = negated)
+    vector<char> seen;              // scratch marks for conflict analysis
+    vector<int> trail;              // assigned literals in order
+    vector<int> trailLim;           // trail size at each decision level
+    int qhead;                      // next trail position to propagate
+
+    vector<double> activity;        // VSIDS variable activity
+    double varInc;
+    float clauseInc;
+    vector<int> heap;               // max-heap of variables by activity
+    vector<int> heapIndex;          // position in heap, or -1
+
+    vector<int> learntClause;       // scratch for conflict analysis
+    vector<int> analyzed;           // scratch for clearing seen marks
+    vector<float> reduceActs;       // scratch for reduceDB
+
+    long decisions, conflicts, propagations;
+
+    int *lits(int c);
+    int litValue(int lit) const;
+    int decisionLevel() const;
+    void enqueue(int lit, int from);
+    int propagate();
+    void analyze(int confl, vector<int> &outLearnt, int &outLevel);
+    bool litRedundant(int lit);
+    void cancelUntil(int lvl);
+    int pickBranchLit();
+    int storeClause(const int *first, int size, bool isLearnt);
+    void attachClause(int c);
+    void reduceDB();
+
+    void bumpVar(int var);
+    void bumpClause(int c);
+    void heapInsert(int var);
+    void heapUp(int pos);
+    void heapDown(int pos);
+    int heapRemoveMax();
+
+    static double luby(double y, int x);
+};
+
+#endif  // SAT_SOLVER
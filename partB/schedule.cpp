@@ -0,0 +1,312 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <cmath>
+#include <thread>
+#include "schedule.h"
+#include "logic.h"
+using namespace std;
+
+/** @brief Adds up log2 of the candidate counts of blank cells
+ * @param state The board
+ * @param limit The number of blank cells to look at, in row order
+ * @return The sum, in bits
+*/
+double candidateBits(const boardState &state, int limit)
+{
+    double bits = 0;
+    for (int cell = 0; cell < CellCount && limit > 0; cell++)
+    {
+        if (state.cells[cell] != Blank)
+            continue;
+        int count = 0;
+        for (unsigned short cand = AllValues & ~state.usedMask(cell); cand; cand &= cand - 1)
+            count++;
+        if (count > 1)
+            bits += log2((double)count);
+        limit--;
+    }
+    return bits;
+}
+
+/** @brief Estimates the work an engine needs for a puzzle
+ * @param puzzle The puzzle
+ * @param engine The engine that will solve it
+ * @return The estimate, in bits; only the order of estimates matters
+*/
+double estimateCost(const boardState &puzzle, engineType engine)
+{
+    if (engine == BacktrackEngine)
+        return candidateBits(puzzle, CostHorizon);
+
+    boardState work = puzzle;
+    if (propagateSingles(work, true) < 0)
+        return 0;
+    return candidateBits(work, CellCount);
+}
+
+/** @brief Constructor for splitSearch class
+ * @param None
+ * @return None
+*/
+splitSearch::splitSearch() : taskCount(0), aboveCalls(0), overflow(false), next(0), done(0), first(0)
+{
+}
+
+/** @brief Cuts the search of a puzzle into subtrees
+ * @param puzzle The puzzle
+ * @param tasks The number of subtrees wanted
+ * @return None
+*/
+void splitSearch::start(const boardState &puzzle, int tasks)
+{
+    boardState state = puzzle;
+    int depth = 0;
+    do  // Goes one level deeper until there are enough subtrees
+    {
+        depth++;
+        taskCount = 0;
+        aboveCalls = 0;
+        overflow = false;
+        expand(state, 0, 0, depth);
+    } while (!overflow && taskCount < tasks && depth < MaxSplitDepth);
+
+    if (overflow)   // The last level had too many subtrees
+    {
+        taskCount = 0;
+        aboveCalls = 0;
+        overflow = false;
+        expand(state, 0, 0, depth - 1);
+    }
+
+    next.store(0, memory_order_relaxed);
+    done.store(0, memory_order_relaxed);
+    first.store(taskCount, memory_order_release);
+}
+
+/** @brief Walks the levels above the subtrees the way board::solveBoard does
+ * @param state The board, restored before returning
+ * @param from The first cell that may be blank
+ * @param depth The level of state
+ * @param maxDepth The level the subtrees start at
+ * @return None
+*/
+void splitSearch::expand(boardState &state, int from, int depth, int maxDepth)
+{
+    int cell = from;
+    while (cell < CellCount && state.cells[cell] != Blank)
+        cell++;
+
+    if (depth == maxDepth || cell == CellCount) // A subtree starts here
+    {
+        if (taskCount == MaxSplitTasks)
+        {
+            overflow = true;
+            return;
+        }
+        subtree &t = tasks[taskCount++];
+        t.state = state;
+        t.before = aboveCalls;
+        return;
+    }
+
+    aboveCalls++;   // The call board::solveBoard makes for this level
+    unsigned short used = state.usedMask(cell);
+    for (int v = 0; v < MaxValue && !overflow; v++)
+        if (!(used & (1 << v)))
+        {
+            state.place(cell, v + MinValue);
+            expand(state, cell + 1, depth + 1, maxDepth);
+            state.remove(cell);
+        }
+}
+
+/** @brief Searches below a board in the order board::solveBoard does
+ * @param state The board, left solved if a solution is found
+ * @param from The first cell that may be blank
+ * @param calls Incremented for every call
+ * @param task The subtree being searched
+ * @return True if a solution was found, false otherwise
+*/
+bool splitSearch::search(boardState &state, int from, long &calls, int task)
+{
+    calls++;
+    if (first.load(memory_order_relaxed) < task)
+        return false;   // An earlier subtree holds the solution
+
+    int cell = from;
+    while (cell < CellCount && state.cells[cell] != Blank)
+        cell++;
+    if (cell == CellCount)
+        return true;
+
+    unsigned short used = state.usedMask(cell);
+    for (int v = 0; v < MaxValue; v++)
+        if (!(used & (1 << v)))
+        {
+            state.place(cell, v + MinValue);
+            if (search(state, cell + 1, calls, task))
+                return true;
+            state.remove(cell);
+        }
+    return false;
+}
+
+/** @brief Reserves the next subtree
+ * @param None
+ * @return The subtree, or -1 if every one has been claimed
+*/
+int splitSearch::claim()
+{
+    if (next.load(memory_order_relaxed) >= taskCount)
+        return -1;
+    int task = next.fetch_add(1, memory_order_relaxed);
+    return task < taskCount ? task : -1;
+}
+
+/** @brief Searches a claimed subtree
+ * @param task The subtree
+ * @return None
+*/
+void splitSearch::run(int task)
+{
+    subtree &t = tasks[task];
+    t.calls = 0;
+    t.solved = search(t.state, 0, t.calls, task);
+    if (t.solved)
+    {
+        int earliest = first.load(memory_order_relaxed);
+        while (task < earliest && !first.compare_exchange_weak(earliest, task, memory_order_relaxed))
+            ;   // Keeps the earliest subtree with a solution
+    }
+    done.fetch_add(1, memory_order_release);
+}
+
+/** @brief Checks if every subtree has been searched
+ * @param None
+ * @return True if the search is over, false otherwise
+*/
+bool splitSearch::finished() const
+{
+    return done.load(memory_order_acquire) == taskCount;
+}
+
+/** @brief Checks if the puzzle was solved
+ * @param None
+ * @return True if some subtree holds a solution, false otherwise
+*/
+bool splitSearch::solved() const
+{
+    return first.load(memory_order_relaxed) < taskCount;
+}
+
+/** @brief Gets the calls the whole search makes
+ * @param None
+ * @return The calls board::solveBoard makes on the puzzle
+*/
+long splitSearch::getCallCount() const
+{
+    int last = solved() ? first.load(memory_order_relaxed) : taskCount - 1;
+    long calls = solved() ? tasks[last].before : aboveCalls;
+    for (int task = 0; task <= last; task++)
+        calls += tasks[task].calls;
+    return calls;
+}
+
+/** @brief Gets the solved board
+ * @param None
+ * @return The board of the first subtree with a solution
+*/
+const boardState &splitSearch::getState() const
+{
+    return tasks[solved() ? first.load(memory_order_relaxed) : 0].state;
+}
+
+/** @brief Constructor for splitPool class
+ * @param threads The number of threads that may post searches
+ * @return None
+*/
+splitPool::splitPool(int threads) : busy(0), open(0)
+{
+    posted.reserve(threads);    // Posting never allocates
+}
+
+/** @brief Searches every subtree of a search with any helpers
+ * @param search The started search
+ * @return None
+*/
+void splitPool::run(splitSearch &search)
+{
+    {
+        lock_guard<mutex> guard(lock);
+        posted.push_back(&search);
+        open++;
+    }
+
+    int task;
+    while ((task = search.claim()) >= 0)
+        search.run(task);
+
+    {
+        lock_guard<mutex> guard(lock);
+        for (size_t k = 0; k < posted.size(); k++)
+            if (posted[k] == &search)
+            {
+                posted.erase(posted.begin() + k);
+                break;
+            }
+        open--;
+    }
+    while (!search.finished())
+        this_thread::yield();   // Helpers finish the subtrees they claimed
+}
+
+/** @brief Searches a subtree of any posted search
+ * @param None
+ * @return True if a subtree was searched, false otherwise
+*/
+bool splitPool::help()
+{
+    if (open.load(memory_order_relaxed) == 0)
+        return false;
+
+    splitSearch *search = NULL;
+    int task = -1;
+    {
+        lock_guard<mutex> guard(lock);  // Claims under the lock so the search stays posted
+        for (size_t k = 0; k < posted.size() && task < 0; k++)
+            if ((task = posted[k]->claim()) >= 0)
+                search = posted[k];
+    }
+    if (search == NULL)
+        return false;
+    search->run(task);
+    return true;
+}
+
+/** @brief Marks this thread as holding a batch
+ * @param None
+ * @return None
+*/
+void splitPool::enter()
+{
+    busy++;
+}
+
+/** @brief Marks this thread as done with its batch
+ * @param None
+ * @return None
+*/
+void splitPool::leave()
+{
+    busy--;
+}
+
+/** @brief Checks if a search may still be posted
+ * @param None
+ * @return True while a thread holds a batch or a search is posted
+*/
+bool splitPool::active() const
+{
+    return busy.load() > 0 || open.load() > 0;
+}
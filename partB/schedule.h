@@ -0,0 +1,119 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef BATCH_SCHEDULE
+#define BATCH_SCHEDULE
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "board.h"
+using namespace std;
+
+// Cost-predictive scheduling for the pipeline. A batch finishes with its
+// slowest puzzle, so puzzles are started in order of estimated cost and
+// the most expensive backtracking searches are cut into subtrees that
+// every solver thread can work on.
+
+const int CostHorizon = 30;         // Blanks, in search order, the backtracking estimate looks at
+const double SplitCost = 64;        // Estimates at or above this are split across threads
+const int SplitTasksPerThread = 8;  // Subtrees per solver thread in a split search
+const int MaxSplitTasks = 256;
+const int MaxSplitDepth = 24;       // Deepest level the subtrees may start at
+
+double estimateCost(const boardState &puzzle, engineType engine);
+// a cheap guess at the work engine needs, in bits: the sum of log2 of
+// the candidate counts of some blank cells. backtracking fills cells in
+// row order without propagation, so the first CostHorizon blanks of the
+// puzzle are used; SAT and the band engine prune as they go, so the cells
+// naked and hidden singles leave blank are used, and the estimate is 0 if
+// singles settle the puzzle
+
+// One backtracking search cut into subtrees in search order. The
+// subtrees can be searched in any order by any thread, and the result
+// is the one board::solveBoard gets: the first subtree with a solution
+// holds it, and the recursive calls are those made above that subtree,
+// in the subtrees before it and in it up to the solution. Subtrees after
+// the first solution stop as soon as they see it.
+class splitSearch
+{
+public:
+    splitSearch();
+
+    void start(const boardState &puzzle, int tasks);
+    // cuts the search of puzzle into at least tasks subtrees where the
+    // tree allows, and at most MaxSplitTasks
+
+    int claim();
+    // reserves the next subtree to search. returns -1 if none is left
+
+    void run(int task);
+    // searches a claimed subtree
+
+    bool finished() const;
+    // true once every subtree has been searched
+
+    bool solved() const;
+    long getCallCount() const;
+    // calls board::solveBoard makes on the puzzle. valid once finished
+
+    const boardState &getState() const;
+    // the solution, if solved
+
+private:
+    struct subtree
+    {
+        boardState state;   // The decisions above the subtree, then its search
+        long before;        // Calls made above the subtrees before this one
+        long calls;
+        bool solved;
+        char after[CacheLine];  // Keeps the threads searching neighbouring subtrees off each other's lines
+    };
+
+    subtree tasks[MaxSplitTasks];
+    int taskCount;
+    long aboveCalls;    // Calls made above the subtrees
+    bool overflow;
+    atomic<int> next;   // Next subtree to claim
+    atomic<int> done;   // Subtrees searched
+    atomic<int> first;  // First subtree with a solution, or taskCount
+
+    void expand(boardState &state, int from, int depth, int maxDepth);
+    bool search(boardState &state, int from, long &calls, int task);
+
+    splitSearch(const splitSearch &);
+    splitSearch &operator=(const splitSearch &);
+};
+
+// Split searches open to every solver thread. A thread that splits a
+// puzzle works through its subtrees and others join in between batches,
+// and once the input is drained, until no thread can split any more.
+class splitPool
+{
+public:
+    splitPool(int threads);
+
+    void run(splitSearch &search);
+    // posts the subtrees of a started search, searches them with any
+    // helpers and returns once every one is done
+
+    bool help();
+    // searches one subtree of a posted search. returns false if no
+    // posted search has a subtree left
+
+    void enter();
+    void leave();
+    // bracket the time a thread holds a batch, from before it waits for
+    // one until it has solved it
+
+    bool active() const;
+    // true while some thread holds a batch or a search is posted
+
+private:
+    mutable mutex lock;
+    vector<splitSearch *> posted;
+    atomic<int> busy;   // Threads holding a batch
+    atomic<int> open;   // Searches posted
+};
+
+#endif  // BATCH_SCHEDULE
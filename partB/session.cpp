@@ -0,0 +1,245 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include "session.h"
+#include "logic.h"
+using namespace std;
+
+/** @brief Gets the name of a hint type
+ * @param hint The hint type
+ * @return A short name for reports
+*/
+const char *hintName(hintType hint)
+{
+    switch (hint)
+    {
+    case NakedSingleHint:
+        return "naked-single";
+    case HiddenSingleHint:
+        return "hidden-single";
+    case SolutionHint:
+        return "solution";
+    default:
+        return "none";
+    }
+}
+
+/** @brief Constructor for playSession class
+ * @param None
+ * @return None
+*/
+playSession::playSession() : play(SquareSize), haveSolution(false), mismatches(0), knownUnsolvable(false),
+                             scratch(SquareSize), searches(0)
+{
+    board::prepare(SatEngine);  // Searches reuse this thread's SAT solver
+    memset(clue, 0, sizeof(clue));
+}
+
+/** @brief Begins a game
+ * @param cells The puzzle, BoardSize * BoardSize characters row by row
+ * @return None
+*/
+void playSession::start(const char *cells)
+{
+    play.initialize(cells);
+    for (int cell = 0; cell < CellCount; cell++)
+        clue[cell] = play.getState().cells[cell] != Blank;
+    haveSolution = false;
+    mismatches = 0;
+    knownUnsolvable = false;
+}
+
+/** @brief Gets the cell number of a row and column
+ * @param i The row
+ * @param j The column
+ * @return The cell number
+*/
+int playSession::cellIndex(int i, int j) const
+{
+    if (i < 1 || i > BoardSize || j < 1 || j > BoardSize)
+        throw rangeError("bad cell in playSession");
+    return (i - 1) * BoardSize + (j - 1);
+}
+
+/** @brief Keeps the mismatch count with the cached solution up to date
+ * @param cell The cell that changed
+ * @param oldVal The value it held, or Blank
+ * @param newVal The value it holds now, or Blank
+ * @return None
+*/
+void playSession::track(int cell, int oldVal, int newVal)
+{
+    if (!haveSolution)
+        return;
+    if (oldVal != Blank && oldVal != solution[cell])
+        mismatches--;
+    if (newVal != Blank && newVal != solution[cell])
+        mismatches++;
+}
+
+/** @brief Makes a move
+ * @param i The row
+ * @param j The column
+ * @param val The value to write
+ * @return False if the cell holds a clue, true otherwise
+*/
+bool playSession::place(int i, int j, int val)
+{
+    int cell = cellIndex(i, j);
+    if (clue[cell])
+        return false;
+    int oldVal = play.getState().cells[cell];
+    play.setCell(i, j, val);    // Throws rangeError on a bad value
+    track(cell, oldVal, val);
+    if (oldVal != Blank && oldVal != val)
+        knownUnsolvable = false;    // Replacing a value may bring solutions back
+    return true;
+}
+
+/** @brief Takes back a move
+ * @param i The row
+ * @param j The column
+ * @return False if the cell holds a clue, true otherwise
+*/
+bool playSession::erase(int i, int j)
+{
+    int cell = cellIndex(i, j);
+    if (clue[cell])
+        return false;
+    int oldVal = play.getState().cells[cell];
+    if (oldVal == Blank)
+        return true;
+    play.clearCell(i, j);
+    track(cell, oldVal, Blank);
+    knownUnsolvable = false;
+    return true;
+}
+
+/** @brief Gets the values that fit in a cell
+ * @param i The row
+ * @param j The column
+ * @return A mask of the values that clash with nothing, 0 for a filled cell
+*/
+unsigned short playSession::candidates(int i, int j) const
+{
+    int cell = cellIndex(i, j);
+    const boardState &state = play.getState();
+    if (state.cells[cell] != Blank)
+        return 0;
+    return AllValues & ~state.usedMask(cell);
+}
+
+/** @brief Checks that the position can still be solved
+ * @param None
+ * @return True if the moves so far lead to a solution, false otherwise
+*/
+bool playSession::isSolvable()
+{
+    if (haveSolution && mismatches == 0)
+        return true;    // The cached solution agrees with every filled cell
+    if (knownUnsolvable)
+        return false;
+
+    searches++;
+    scratch.setState(play.getState());
+    if (!scratch.solveSAT())
+    {
+        knownUnsolvable = true;
+        return false;
+    }
+
+    memcpy(solution, scratch.getState().cells, sizeof(solution));
+    haveSolution = true;
+    mismatches = 0;
+    return true;
+}
+
+/** @brief Suggests the next move
+ * @param None
+ * @return The move, or a hint of type NoHint
+*/
+sessionHint playSession::hint()
+{
+    sessionHint result;
+    result.type = NoHint;
+    result.row = result.col = result.value = 0;
+    if (isSolved() || !isSolvable())
+        return result;
+
+    const boardState &state = play.getState();
+    int cell, val;
+    bool isHidden;
+    if (findSingle(state, true, cell, val, isHidden))
+        result.type = isHidden ? HiddenSingleHint : NakedSingleHint;
+    else
+    {
+        int fewest = MaxValue + 1;
+        for (int c = 0; c < CellCount; c++)
+        {
+            if (state.cells[c] != Blank)
+                continue;
+            unsigned short cand = AllValues & ~state.usedMask(c);
+            int count = 0;
+            for (; cand; cand &= cand - 1)
+                count++;
+            if (count < fewest)
+            {
+                fewest = count;
+                cell = c;
+            }
+        }
+        val = solution[cell];   // isSolvable left a solution matching the board
+        result.type = SolutionHint;
+    }
+
+    result.row = cell / BoardSize + 1;
+    result.col = cell % BoardSize + 1;
+    result.value = val;
+    return result;
+}
+
+/** @brief Checks if every cell is filled without a clash
+ * @param None
+ * @return True if the game is won, false otherwise
+*/
+bool playSession::isSolved() const
+{
+    return play.getState().filled == CellCount && !hasDuplicates(play.getState());
+}
+
+/** @brief Checks if a cell holds a clue
+ * @param i The row
+ * @param j The column
+ * @return True if the cell was given by the puzzle
+*/
+bool playSession::isClue(int i, int j) const
+{
+    return clue[cellIndex(i, j)];
+}
+
+/** @brief Gets the board being played
+ * @param None
+ * @return The clues and moves
+*/
+const board &playSession::getBoard() const
+{
+    return play;
+}
+
+/** @brief Prints the board being played
+ * @param out The stream to print to
+ * @return None
+*/
+void playSession::print(ostream &out)
+{
+    play.print(out);
+}
+
+/** @brief Gets the number of searches run
+ * @param None
+ * @return How often isSolvable could not answer from its cache
+*/
+long playSession::getSearches() const
+{
+    return searches;
+}
@@ -0,0 +1,78 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef PLAY_SESSION
+#define PLAY_SESSION
+
+#include "board.h"
+
+enum hintType { NakedSingleHint, HiddenSingleHint, SolutionHint, NoHint };
+
+const char *hintName(hintType hint);
+
+// A move suggested by playSession::hint
+struct sessionHint
+{
+    hintType type;
+    int row, col;   // Cell to fill, 1 to BoardSize
+    int value;
+};
+
+// Incremental state for a game in progress. Moves update the board's unit
+// masks in place, so candidate queries are a few mask operations. The last
+// solution found is kept together with the number of filled cells that
+// disagree with it; while that number is 0 the position is known to be
+// solvable and no search is run. A position found unsolvable stays so
+// until a cell is erased, since placing values only removes solutions.
+class playSession
+{
+public:
+    playSession();
+
+    void start(const char *cells);
+    // begins a game on a puzzle given as BoardSize * BoardSize characters.
+    // its clues cannot be changed by moves
+
+    bool place(int i, int j, int val);
+    // writes val into cell (i, j), replacing any earlier move. returns
+    // false if the cell holds a clue. throws rangeError on a bad cell or
+    // value
+
+    bool erase(int i, int j);
+    // blanks cell (i, j). returns false if the cell holds a clue
+
+    unsigned short candidates(int i, int j) const;
+    // mask of the values that do not clash with the row, column or square
+    // of cell (i, j), bit val - MinValue for val. 0 for a filled cell
+
+    bool isSolvable();
+    // true if the current moves can be completed to a solution
+
+    sessionHint hint();
+    // the next logical move: a naked single, then a hidden single, and
+    // otherwise the solution value of the blank cell with the fewest
+    // candidates. NoHint if the position cannot be solved
+
+    bool isSolved() const;
+    bool isClue(int i, int j) const;
+    const board &getBoard() const;
+    void print(ostream &out = cout);
+
+    long getSearches() const;
+    // number of times isSolvable had to search
+
+private:
+    board play;                     // Clues and moves
+    bool clue[CellCount];           // True for cells given by the puzzle
+    signed char solution[CellCount];    // Last solution found
+    bool haveSolution;
+    int mismatches;                 // Filled cells that differ from solution
+    bool knownUnsolvable;           // Set by a failed search, cleared by erase
+    board scratch;                  // Work board for searches
+    long searches;
+
+    int cellIndex(int i, int j) const;
+    void track(int cell, int oldVal, int newVal);
+};
+
+#endif  // PLAY_SESSION
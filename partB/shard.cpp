@@ -0,0 +1,240 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "shard.h"
+#include "source.h"
+using namespace std;
+
+/** @brief Counts the characters of a line that belong to a record
+ * @param line The line, without its newline
+ * @return The characters other than spaces, tabs and carriage returns
+*/
+int recordChars(const string &line)
+{
+    int count = 0;
+    for (size_t k = 0; k < line.size(); k++)
+        if (line[k] != ' ' && line[k] != '\t' && line[k] != '\r')
+            count++;
+    return count;
+}
+
+/** @brief Counts the rows of a record that come before a line
+ * @param fin The file
+ * @param from A record start at or before start
+ * @param start The start of the line
+ * @return The rows of BoardSize characters between start and the nearest
+ *         line before it that is blank, holds any other number of
+ *         characters or begins at from
+ * @note Reads back from start in growing windows, so only the lines of
+ *       the record that start falls in are read
+*/
+long rowsBefore(ifstream &fin, long from, long start)
+{
+    for (long window = 1024;; window *= 2)
+    {
+        long begin = max(from, start - window);
+        string text(start - begin, '\0');
+        fin.clear();
+        fin.seekg(begin);
+        if (!fin.read(&text[0], text.size()))
+            return 0;
+
+        long rows = 0;
+        size_t end = text.size();   // Just past the newline of the line being looked at
+        while (end > 0)
+        {
+            size_t close = end - 1;
+            size_t open = close == 0 ? string::npos : text.rfind('\n', close - 1);
+            if (open == string::npos && begin > from)
+                break;  // The line may begin before the window
+            size_t first = open == string::npos ? 0 : open + 1;
+            if (recordChars(text.substr(first, close - first)) != BoardSize)
+                return rows;
+            rows++;
+            end = first;
+        }
+        if (end == 0 && begin == from)
+            return rows;
+    }
+}
+
+/** @brief Cuts a text puzzle file into record-aligned byte ranges
+ * @param fileName The file to split
+ * @param shards The number of ranges
+ * @param bounds Set to the shards + 1 offsets between the ranges
+ * @return True if the file could be read, false otherwise
+ * @note Each cut seeks to its share of the file, goes on to the next line
+ *       and, if that line is a row of a record of BoardSize lines, on to
+ *       the line after the record. Only the lines around each cut are read
+*/
+bool splitText(const char *fileName, int shards, vector<long> &bounds)
+{
+    ifstream fin(fileName, ios::binary);
+    if (!fin)
+        return false;
+    fin.seekg(0, ios::end);
+    long size = (long)fin.tellg();
+
+    bounds.assign(1, 0);
+    for (int k = 1; k < shards; k++)
+    {
+        long pos = max(size * k / shards, bounds.back());
+        if (pos > bounds.back())
+        {
+            fin.clear();
+            fin.seekg(pos - 1);
+            int ch;
+            while ((ch = fin.get()) != EOF && ch != '\n')
+                ;   // Moves to the start of the next line
+            pos = ch == EOF ? size : (long)fin.tellg();
+        }
+
+        int length = pos < size ? (int)(rowsBefore(fin, bounds.back(), pos) % BoardSize * BoardSize) : 0;
+        fin.clear();
+        fin.seekg(pos);
+        string line;
+        while (length != 0 && pos < size && getline(fin, line))
+        {
+            pos += (long)line.size() + 1;
+            int chars = recordChars(line);
+            if (chars != 0)
+                length = chars != BoardSize || length + chars >= CellCount ? 0 : length + chars;
+        }
+        bounds.push_back(min(pos, size));   // Past the end of the record the line belongs to
+    }
+    bounds.push_back(size);
+    return true;
+}
+
+/** @brief Forks a worker for one shard
+ * @param shard The shard to work on
+ * @param work The work done in the child
+ * @return The process id, or -1 if the fork failed
+*/
+pid_t forkShard(int shard, const function<int(int)> &work)
+{
+    cout.flush();   // Nothing buffered may be written twice
+    cerr.flush();
+    pid_t pid = fork();
+    if (pid != 0)
+        return pid;
+
+    int code = 1;
+    try
+    {
+        code = work(shard);
+    }
+    catch (...)
+    {
+        code = 1;
+    }
+    cout.flush();
+    _exit(code);
+}
+
+/** @brief Runs every shard in its own process, repeating the failed ones
+ * @param shards The number of shards
+ * @param work The work done for a shard, returning 0 on success
+ * @param log The stream for failure reports
+ * @return True if every shard succeeded, false otherwise
+*/
+bool runShards(int shards, const function<int(int)> &work, ostream &log)
+{
+    map<pid_t, int> running;    // Shard of each worker
+    vector<int> attempts(shards, 1);
+    bool ok = true;
+
+    for (int shard = 0; shard < shards; shard++)
+    {
+        pid_t pid = forkShard(shard, work);
+        if (pid < 0)
+            return false;
+        running[pid] = shard;
+    }
+
+    while (!running.empty())
+    {
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0)
+            return false;
+        map<pid_t, int>::iterator it = running.find(pid);
+        if (it == running.end())
+            continue;
+        int shard = it->second;
+        running.erase(it);
+        if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+            continue;
+
+        log << "Shard " << shard << " ";
+        if (WIFSIGNALED(status))
+            log << "killed by signal " << WTERMSIG(status);
+        else
+            log << "exited with status " << WEXITSTATUS(status);
+        if (attempts[shard] >= ShardAttempts)
+        {
+            log << ", giving up" << endl;
+            ok = false;
+            continue;
+        }
+        log << ", running it again" << endl;
+        attempts[shard]++;
+        pid = forkShard(shard, work);
+        if (pid < 0)
+            return false;
+        running[pid] = shard;
+    }
+    return ok;
+}
+
+/** @brief Creates a scratch directory for shard files
+ * @param None
+ * @return The directory, or an empty string on failure
+*/
+string makeScratchDir()
+{
+    const char *tmp = getenv("TMPDIR");
+    string pattern = string(tmp != NULL && *tmp ? tmp : "/tmp") + "/sudoku-shards-XXXXXX";
+    vector<char> name(pattern.begin(), pattern.end());
+    name.push_back('\0');
+    if (mkdtemp(&name[0]) == NULL)
+        return "";
+    return &name[0];
+}
+
+/** @brief Gets the name of a shard file
+ * @param dir The scratch directory
+ * @param shard The shard
+ * @param suffix The kind of file
+ * @return The path
+*/
+string shardFile(const string &dir, int shard, const char *suffix)
+{
+    ostringstream name;
+    name << dir << "/shard" << shard << suffix;
+    return name.str();
+}
+
+/** @brief Removes the scratch directory and its shard files
+ * @param dir The scratch directory
+ * @param shards The number of shards
+ * @return None
+*/
+void removeScratchDir(const string &dir, int shards)
+{
+    for (int shard = 0; shard < shards; shard++)
+    {
+        remove(shardFile(dir, shard, ".out").c_str());
+        remove(shardFile(dir, shard, ".stats").c_str());
+    }
+    rmdir(dir.c_str());
+}
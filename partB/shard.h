@@ -0,0 +1,40 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef SHARD_RUNNER
+#define SHARD_RUNNER
+
+#include <functional>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Splitting one batch run over several worker processes on this machine.
+// Each worker is forked from the driver, handles one shard and reports
+// through files in a scratch directory; a shard whose worker crashes or
+// fails is run again in a new process.
+
+const int ShardAttempts = 3;    // Runs of one shard before giving up
+
+bool splitText(const char *fileName, int shards, vector<long> &bounds);
+// fills bounds with shards + 1 byte offsets that cut a text puzzle file
+// into ranges of about equal size, each starting at a record as
+// readPuzzle reads them. records of BoardSize rows are taken to begin
+// after a blank line, a line that is not a row, or the range before.
+// returns false if the file cannot be read
+
+bool runShards(int shards, const function<int(int)> &work, ostream &log);
+// forks a process per shard that calls work(shard) and exits with its
+// result. shards whose process is killed or exits nonzero are forked
+// again, up to ShardAttempts runs each. returns true once every shard
+// has succeeded
+
+string makeScratchDir();
+// creates a private directory for shard files. empty on failure
+
+string shardFile(const string &dir, int shard, const char *suffix);
+// name of a shard's file in the scratch directory
+
+void removeScratchDir(const string &dir, int shards);
+
+#endif  // SHARD_RUNNER
@@ -0,0 +1,226 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <sstream>
+#include "source.h"
+using namespace std;
+
+/** @brief Reads the next puzzle from a stream
+ * @param fin The stream to read from
+ * @param cells The BoardSize * BoardSize characters of the puzzle
+ * @param length Set to the number of characters in the record
+ * @return True if a record was read, false at the ending character or end of file
+*/
+bool readPuzzle(istream &fin, char *cells, int &length)
+{
+    fin >> ws;
+    if (!fin || fin.peek() == EOF || fin.peek() == 'Z') // Stops at the end of the file or the ending character
+        return false;
+
+    int onLine = 0; // Characters of the record on the current line
+    length = 0;
+    while (length < CellCount)
+    {
+        int ch = fin.get();
+        if (ch == EOF)
+            return length > 0;  // Cut short by the end of the file
+        if (ch == '\n')
+        {
+            if (onLine != 0 && onLine != BoardSize)
+                return true;    // A line that is neither a whole record nor a row
+            onLine = 0;
+            continue;
+        }
+        if (ch == ' ' || ch == '\t' || ch == '\r')
+            continue;
+        cells[length++] = (char)ch;
+        onLine++;
+    }
+
+    int ch;
+    while ((ch = fin.peek()) != EOF && ch != '\n' && ch != 'Z')
+    {
+        fin.get();
+        if (ch != ' ' && ch != '\t' && ch != '\r')
+            length++;   // The line runs past the record
+    }
+    return true;
+}
+
+/** @brief Gets the reason a source stopped early
+ * @param None
+ * @return The error, or an empty string
+*/
+string puzzleSource::error() const
+{
+    return "";
+}
+
+/** @brief Gets the length of the last record
+ * @param None
+ * @return CellCount, as every record of this source is whole
+*/
+int puzzleSource::recordLength() const
+{
+    return CellCount;
+}
+
+/** @brief Constructor for textSource class
+ * @param in The stream to read from
+ * @return None
+*/
+textSource::textSource(istream &in) : fin(in), end(-1), length(CellCount)
+{
+}
+
+/** @brief Reads the next puzzle
+ * @param cells The puzzle
+ * @return False at the end of the puzzles
+*/
+bool textSource::next(char *cells)
+{
+    if (end >= 0)
+    {
+        fin >> ws;
+        if (!fin || (long)fin.tellg() >= end)
+            return false;   // The next record belongs to another range
+    }
+    return readPuzzle(fin, cells, length);
+}
+
+/** @brief Gets the length of the last record
+ * @param None
+ * @return The number of characters it held
+*/
+int textSource::recordLength() const
+{
+    return length;
+}
+
+/** @brief Gets the byte offset of the next puzzle
+ * @param None
+ * @return The offset in the stream
+*/
+long textSource::position()
+{
+    if (!fin)   // At the end of the file
+    {
+        fin.clear();
+        fin.seekg(0, ios::end);
+    }
+    return (long)fin.tellg();
+}
+
+/** @brief Moves to a byte offset
+ * @param position An offset from position()
+ * @return True if the stream could seek there
+*/
+bool textSource::seek(long position)
+{
+    fin.clear();
+    fin.seekg(position);
+    return (bool)fin;
+}
+
+/** @brief Limits the source to a byte range of the stream
+ * @param begin The offset of the first record to read
+ * @param end The offset to stop at
+ * @return None
+*/
+void textSource::setRange(long begin, long end)
+{
+    fin.seekg(begin);
+    this->end = end;
+}
+
+/** @brief Constructor for archiveSource class
+ * @param source An open archive
+ * @return None
+*/
+archiveSource::archiveSource(const puzzleArchive &source) : archive(source), block(-1), lastBlock(-1), remaining(0),
+                                                             pos(NULL), consumed(0)
+{
+}
+
+/** @brief Gets the index of the next puzzle
+ * @param None
+ * @return The number of records before it
+*/
+long archiveSource::position()
+{
+    return consumed;
+}
+
+/** @brief Moves to a record
+ * @param position A record index from position()
+ * @return True if the archive holds that many records
+*/
+bool archiveSource::seek(long position)
+{
+    if (position < 0 || position > archive.size())
+        return false;
+    block = -1;
+    remaining = 0;
+    consumed = 0;
+    while (block + 1 < archive.blockCount() && consumed + archive.blockSize(block + 1) <= position)
+        consumed += archive.blockSize(++block); // Whole blocks are skipped without decoding
+
+    char cells[CellCount];
+    while (consumed < position)
+        if (!next(cells))
+            return false;   // Decodes up to the record within its block
+    return true;
+}
+
+/** @brief Limits the source to a range of blocks
+ * @param first The first block to decode
+ * @param last The block to stop at
+ * @return None
+*/
+void archiveSource::setBlocks(int first, int last)
+{
+    block = first - 1;
+    lastBlock = last;
+    remaining = 0;
+    consumed = 0;
+    for (int b = 0; b < first && b < archive.blockCount(); b++)
+        consumed += archive.blockSize(b);
+}
+
+/** @brief Decodes the next puzzle, checking each block as it is reached
+ * @param cells The puzzle
+ * @return False at the end of the archive or at a damaged block
+*/
+bool archiveSource::next(char *cells)
+{
+    if (remaining == 0)
+    {
+        int stop = lastBlock >= 0 ? min(lastBlock, archive.blockCount()) : archive.blockCount();
+        if (!failure.empty() || block + 1 >= stop)
+            return false;
+        block++;
+        if (!archive.verifyBlock(block))
+        {
+            ostringstream msg;
+            msg << "checksum mismatch in archive block " << block;
+            failure = msg.str();
+            return false;
+        }
+        pos = archive.blockData(block);
+        remaining = archive.blockSize(block);
+    }
+
+    pos = decodeRecord(pos, archive.hasSolutions(), cells, NULL);
+    remaining--;
+    consumed++;
+    return true;
+}
+
+/** @brief Gets the reason the archive stopped early
+ * @param None
+ * @return The error, or an empty string
+*/
+string archiveSource::error() const
+{
+    return failure;
+}
@@ -0,0 +1,83 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef PUZZLE_SOURCE
+#define PUZZLE_SOURCE
+
+#include <iostream>
+#include <string>
+#include "archive.h"
+using namespace std;
+
+// A stream of puzzles, each delivered as BoardSize * BoardSize characters
+class puzzleSource
+{
+public:
+    virtual ~puzzleSource() {}
+
+    virtual bool next(char *cells) = 0;
+    // reads the next puzzle. returns false at the end or on an error
+
+    virtual string error() const;
+    // reason the stream stopped early, empty if it simply ended
+
+    virtual int recordLength() const;
+    // characters in the last puzzle read. CellCount unless the record was
+    // too short or too long, in which case its cells are not usable
+
+    virtual long position() = 0;
+    // where the next puzzle starts, for seek
+
+    virtual bool seek(long position) = 0;
+    // continues from a position returned by position(). returns false if
+    // the position cannot be reached
+};
+
+// Puzzles in sudoku.txt form, ending at 'Z' or the end of the file. A
+// record is one line of CellCount characters or BoardSize lines of
+// BoardSize; a line of any other length ends its record early, so one
+// bad line does not shift the records after it
+class textSource : public puzzleSource
+{
+public:
+    textSource(istream &in);
+    bool next(char *cells);
+    int recordLength() const;
+    long position();
+    bool seek(long position);
+
+    void setRange(long begin, long end);
+    // reads only the records that start at byte offsets in [begin, end)
+
+private:
+    istream &fin;
+    long end;   // Offset to stop at, -1 for the end of the file
+    int length; // Characters in the last record
+};
+
+// Puzzles decoded in order from a mapped archive
+class archiveSource : public puzzleSource
+{
+public:
+    archiveSource(const puzzleArchive &source);
+    bool next(char *cells);
+    string error() const;
+    long position();
+    bool seek(long position);
+
+    void setBlocks(int first, int last);
+    // decodes only blocks first to last - 1
+
+private:
+    const puzzleArchive &archive;
+    int block;                  // Block being decoded
+    int lastBlock;              // Block to stop at, -1 for the last one
+    int remaining;              // Records left in it
+    const unsigned char *pos;   // Next record
+    long consumed;              // Records decoded so far, counted from the start of the archive
+    string failure;
+};
+
+bool readPuzzle(istream &fin, char *cells, int &length);
+
+#endif  // PUZZLE_SOURCE
@@ -0,0 +1,439 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include "store.h"
+using namespace std;
+
+const int StoreScanChunk = 64;  // Puzzles a solver thread claims at a time
+
+/** @brief Constructor for storeQuery struct
+ * @param None
+ * @return None
+*/
+storeQuery::storeQuery() : minClues(0), maxClues(CellCount), grade(-1), minCalls(-1), maxCalls(-1),
+    unsolvedOnly(false)
+{
+}
+
+/** @brief Reads a query from its text form
+ * @param spec Comma separated conditions
+ * @param query Filled in from the conditions
+ * @return False on a term that is not understood
+*/
+bool parseQuery(const char *spec, storeQuery &query)
+{
+    string text(spec);
+    size_t pos = 0;
+    while (pos <= text.size())
+    {
+        size_t end = text.find(',', pos);
+        if (end == string::npos)
+            end = text.size();
+        string term = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (term.empty())
+            continue;
+
+        size_t op = term.find_first_of("=<>");
+        if (term == "unsolved")
+        {
+            query.unsolvedOnly = true;
+            continue;
+        }
+        if (op == string::npos)
+            return false;
+
+        string key = term.substr(0, op), value = term.substr(op + 1);
+        char rel = term[op];
+        if (key == "grade" && rel == '=')
+        {
+            int g = NakedSinglesGrade;
+            while (g <= InvalidGrade && value != gradeName((gradeType)g))
+                g++;
+            if (g > InvalidGrade)
+                return false;
+            query.grade = g;
+            continue;
+        }
+
+        char *rest;
+        long n = strtol(value.c_str(), &rest, 10);
+        if (value.empty() || *rest != '\0')
+            return false;
+        if (key == "clues")
+        {
+            if (rel != '<')
+                query.minClues = (int)(rel == '>' ? n + 1 : n);
+            if (rel != '>')
+                query.maxClues = (int)(rel == '<' ? n - 1 : n);
+        }
+        else if (key == "calls")
+        {
+            if (rel != '<')
+                query.minCalls = rel == '>' ? n + 1 : n;
+            if (rel != '>')
+                query.maxCalls = rel == '<' ? n - 1 : n;
+        }
+        else
+            return false;
+    }
+    return true;
+}
+
+/** @brief Computes the canonical hash of a puzzle
+ * @param cells The puzzle
+ * @return A 64-bit FNV-1a hash of the smallest equivalent form
+*/
+unsigned long long canonicalHash(const char *cells)
+{
+    static const int perms[6][SquareSize] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 },
+                                              { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+    char best[CellCount], form[CellCount];
+    bool haveBest = false;
+
+    for (int transpose = 0; transpose < 2; transpose++)
+        for (int bands = 0; bands < 6; bands++)
+            for (int stacks = 0; stacks < 6; stacks++)
+            {
+                char relabel[MaxValue + 1] = { 0 };
+                char nextLabel = '1';
+                for (int r = 0; r < BoardSize; r++)
+                    for (int c = 0; c < BoardSize; c++)
+                    {
+                        int sr = perms[bands][r / SquareSize] * SquareSize + r % SquareSize;
+                        int sc = perms[stacks][c / SquareSize] * SquareSize + c % SquareSize;
+                        char ch = transpose ? cells[sc * BoardSize + sr] : cells[sr * BoardSize + sc];
+                        int v = ch - '0';
+                        if (v < MinValue || v > MaxValue)
+                            ch = '.';
+                        else
+                        {
+                            if (relabel[v] == 0)
+                                relabel[v] = nextLabel++;   // Values numbered by first appearance
+                            ch = relabel[v];
+                        }
+                        form[r * BoardSize + c] = ch;
+                    }
+                if (!haveBest || memcmp(form, best, CellCount) < 0)
+                {
+                    memcpy(best, form, CellCount);
+                    haveBest = true;
+                }
+            }
+
+    unsigned long long hash = 14695981039346656037ULL;
+    for (int k = 0; k < CellCount; k++)
+    {
+        hash ^= (unsigned char)best[k];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/** @brief Constructor for puzzleStore class
+ * @param None
+ * @return None
+*/
+puzzleStore::puzzleStore() : byClues(CellCount + 1), byGrade(InvalidGrade + 1)
+{
+}
+
+/** @brief Gets the number of puzzles
+ * @param None
+ * @return The puzzle count
+*/
+long puzzleStore::size() const
+{
+    return (long)clues.size();
+}
+
+/** @brief Appends every puzzle from a source
+ * @param source The puzzles to load, text or archive
+ * @return The number of puzzles added
+*/
+long puzzleStore::load(puzzleSource &source)
+{
+    char cells[CellCount];
+    long added = 0;
+    while (source.next(cells))
+    {
+        add(cells);
+        added++;
+    }
+    buildIndexes();
+    return added;
+}
+
+/** @brief Appends one puzzle
+ * @param cells The puzzle
+ * @return The id of the puzzle
+*/
+long puzzleStore::add(const char *cells)
+{
+    boardState state;
+    state.clear();
+    unsigned char nibbles[PackedCellBytes] = { 0 };
+    bool valid = true;
+    for (int k = 0; k < CellCount; k++)
+    {
+        int v = cells[k] - '0';
+        if (cells[k] == '.')
+            continue;
+        if (v < MinValue || v > MaxValue)
+        {
+            valid = false;  // Unknown characters make the puzzle invalid
+            continue;
+        }
+        nibbles[k / 2] |= (unsigned char)(k % 2 ? v << 4 : v);
+        state.place(k, v);
+    }
+
+    packed.insert(packed.end(), nibbles, nibbles + PackedCellBytes);
+    clues.push_back(state.filled);
+    hashes.push_back(canonicalHash(cells));
+    grades.push_back(valid ? gradePuzzle(state) : InvalidGrade);
+    lastCalls.push_back(-1);
+    lastMicros.push_back(0.0f);
+    lastSolved.push_back(0);
+    return size() - 1;
+}
+
+/** @brief Rebuilds the clue count, grade and hash indexes
+ * @param None
+ * @return None
+*/
+void puzzleStore::buildIndexes()
+{
+    for (size_t n = 0; n < byClues.size(); n++)
+        byClues[n].clear();
+    for (size_t g = 0; g < byGrade.size(); g++)
+        byGrade[g].clear();
+
+    byHash.resize(size());
+    for (long id = 0; id < size(); id++)
+    {
+        byClues[clues[id]].push_back(id);
+        byGrade[grades[id]].push_back(id);
+        byHash[id] = id;
+    }
+
+    const vector<unsigned long long> &h = hashes;
+    sort(byHash.begin(), byHash.end(), [&h](long a, long b) { return h[a] < h[b] || (h[a] == h[b] && a < b); });
+}
+
+/** @brief Unpacks the cells of a puzzle
+ * @param id The puzzle
+ * @param cells The BoardSize * BoardSize characters of the puzzle
+ * @return None
+*/
+void puzzleStore::getCells(long id, char *cells) const
+{
+    const unsigned char *p = &packed[id * PackedCellBytes];
+    for (int k = 0; k < CellCount; k++)
+    {
+        int v = (k % 2) ? p[k / 2] >> 4 : p[k / 2] & 0xF;
+        cells[k] = v ? (char)('0' + v) : '.';
+    }
+}
+
+/** @brief Gets the clue count of a puzzle
+ * @param id The puzzle
+ * @return The number of givens
+*/
+int puzzleStore::getClues(long id) const
+{
+    return clues[id];
+}
+
+/** @brief Gets the canonical hash of a puzzle
+ * @param id The puzzle
+ * @return The hash
+*/
+unsigned long long puzzleStore::getHash(long id) const
+{
+    return hashes[id];
+}
+
+/** @brief Gets the difficulty grade of a puzzle
+ * @param id The puzzle
+ * @return The grade
+*/
+gradeType puzzleStore::getGrade(long id) const
+{
+    return (gradeType)grades[id];
+}
+
+/** @brief Gets the recursive calls of the last solve
+ * @param id The puzzle
+ * @return The call count, -1 if never solved
+*/
+long puzzleStore::getLastCalls(long id) const
+{
+    return lastCalls[id];
+}
+
+/** @brief Gets the time of the last solve
+ * @param id The puzzle
+ * @return Microseconds spent solving
+*/
+float puzzleStore::getLastMicros(long id) const
+{
+    return lastMicros[id];
+}
+
+/** @brief Checks whether the last solve succeeded
+ * @param id The puzzle
+ * @return True if the puzzle was solved
+*/
+bool puzzleStore::getLastSolved(long id) const
+{
+    return lastSolved[id] != 0;
+}
+
+/** @brief Checks one puzzle against a query
+ * @param id The puzzle
+ * @param query The conditions
+ * @return True if every condition holds
+*/
+bool puzzleStore::matches(long id, const storeQuery &query) const
+{
+    if (clues[id] < query.minClues || clues[id] > query.maxClues)
+        return false;
+    if (query.grade >= 0 && grades[id] != query.grade)
+        return false;
+    if (query.minCalls >= 0 && lastCalls[id] < query.minCalls)
+        return false;
+    if (query.maxCalls >= 0 && (lastCalls[id] < 0 || lastCalls[id] > query.maxCalls))
+        return false;
+    if (query.unsolvedOnly && (lastCalls[id] < 0 || lastSolved[id]))
+        return false;
+    return true;
+}
+
+/** @brief Finds the puzzles matching a query
+ * @param query The conditions
+ * @return The matching ids in increasing order
+*/
+vector<long> puzzleStore::find(const storeQuery &query) const
+{
+    vector<long> result;
+    int lo = max(query.minClues, 0), hi = min(query.maxClues, CellCount);
+    long viaClues = 0;
+    for (int n = lo; n <= hi; n++)
+        viaClues += (long)byClues[n].size();
+    long viaGrade = query.grade >= 0 && query.grade <= InvalidGrade ? (long)byGrade[query.grade].size() : size();
+
+    if (viaClues < size() || viaGrade < size())  // Walks the narrower index
+    {
+        if (viaClues <= viaGrade)
+        {
+            for (int n = lo; n <= hi; n++)
+                for (size_t k = 0; k < byClues[n].size(); k++)
+                    if (matches(byClues[n][k], query))
+                        result.push_back(byClues[n][k]);
+            sort(result.begin(), result.end());
+        }
+        else
+        {
+            for (size_t k = 0; k < byGrade[query.grade].size(); k++)
+                if (matches(byGrade[query.grade][k], query))
+                    result.push_back(byGrade[query.grade][k]);
+        }
+        return result;
+    }
+
+    for (long id = 0; id < size(); id++)
+        if (matches(id, query))
+            result.push_back(id);
+    return result;
+}
+
+/** @brief Finds the puzzles with a canonical hash
+ * @param hash The hash to look up
+ * @return The ids of equivalent puzzles in increasing order
+*/
+vector<long> puzzleStore::findHash(unsigned long long hash) const
+{
+    const vector<unsigned long long> &h = hashes;
+    vector<long>::const_iterator it = lower_bound(byHash.begin(), byHash.end(), hash,
+        [&h](long id, unsigned long long value) { return h[id] < value; });
+
+    vector<long> result;
+    for (; it != byHash.end() && hashes[*it] == hash; ++it)
+        result.push_back(*it);
+    return result;
+}
+
+/** @brief Solves puzzles in parallel and records their statistics
+ * @param ids The puzzles to solve
+ * @param engine The engine to solve with
+ * @param numThreads The number of solver threads
+ * @return Totals over the solved puzzles
+*/
+storeSolveStats puzzleStore::solve(const vector<long> &ids, engineType engine, int numThreads)
+{
+    atomic<size_t> next(0);
+    atomic<long> solved(0), calls(0);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    auto worker = [&]()
+    {
+        board b(SquareSize);
+        board::prepare(engine);
+        char cells[CellCount];
+        long mySolved = 0, myCalls = 0;
+        size_t first;
+        while ((first = next.fetch_add(StoreScanChunk)) < ids.size())
+        {
+            size_t last = min(first + StoreScanChunk, ids.size());
+            for (size_t k = first; k < last; k++)
+            {
+                long id = ids[k];
+                getCells(id, cells);
+                chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+                bool ok = false;
+                b.resetCallCount();
+                try
+                {
+                    b.initialize(cells);
+                    ok = b.solve(engine) && b.isSolved();
+                }
+                catch (baseException &)
+                {
+                    ok = false; // Invalid puzzles are recorded as unsolved
+                }
+                chrono::duration<float, micro> elapsed = chrono::steady_clock::now() - t0;
+
+                lastCalls[id] = b.getCallCount();   // Each id is written by one thread only
+                lastMicros[id] = elapsed.count();
+                lastSolved[id] = ok;
+                if (ok)
+                    mySolved++;
+                myCalls += b.getCallCount();
+            }
+        }
+        solved += mySolved;
+        calls += myCalls;
+    };
+
+    vector<thread> workers;
+    for (int t = 1; t < numThreads; t++)
+        workers.push_back(thread(worker));
+    worker();   // The calling thread solves too
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+
+    storeSolveStats stats;
+    stats.puzzles = (long)ids.size();
+    stats.solved = solved;
+    stats.calls = calls;
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return stats;
+}
@@ -0,0 +1,98 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef PUZZLE_STORE
+#define PUZZLE_STORE
+
+#include <vector>
+#include "board.h"
+#include "logic.h"
+#include "source.h"
+using namespace std;
+
+const int PackedCellBytes = (CellCount + 1) / 2;    // 4 bits per cell
+
+// Conditions for a store query. Unset bounds match everything
+struct storeQuery
+{
+    int minClues, maxClues;     // Clue count range
+    int grade;                  // gradeType, or -1 for any
+    long minCalls, maxCalls;    // Recursive calls of the last solve, -1 if unset
+    bool unsolvedOnly;          // Only puzzles whose last solve failed
+
+    storeQuery();
+};
+
+// Summary of a parallel solve over store puzzles
+struct storeSolveStats
+{
+    long puzzles;
+    long solved;
+    long calls;
+    double seconds;
+};
+
+// Puzzles held column by column: packed cells, clue count, canonical hash,
+// last solve statistics and difficulty grade each live in their own array,
+// so a scan touches only the columns it filters on. Clue count and grade
+// have bucket indexes and the hash has a sorted index.
+class puzzleStore
+{
+public:
+    puzzleStore();
+
+    long size() const;
+
+    long load(puzzleSource &source);
+    // appends every puzzle of a source and rebuilds the indexes.
+    // returns the number of puzzles added
+
+    long add(const char *cells);
+    // appends one puzzle. call buildIndexes() after a series of adds
+
+    void buildIndexes();
+
+    void getCells(long id, char *cells) const;
+    int getClues(long id) const;
+    unsigned long long getHash(long id) const;
+    gradeType getGrade(long id) const;
+    long getLastCalls(long id) const;
+    // recursive calls of the last solve, -1 if never solved
+    float getLastMicros(long id) const;
+    bool getLastSolved(long id) const;
+
+    vector<long> find(const storeQuery &query) const;
+    // ids of matching puzzles, in id order
+
+    vector<long> findHash(unsigned long long hash) const;
+    // ids of puzzles with a canonical hash, i.e. equivalent puzzles
+
+    storeSolveStats solve(const vector<long> &ids, engineType engine, int numThreads);
+    // solves the puzzles in parallel and records their statistics
+
+private:
+    vector<unsigned char> packed;       // PackedCellBytes per puzzle
+    vector<unsigned char> clues;
+    vector<unsigned long long> hashes;
+    vector<unsigned char> grades;
+    vector<int> lastCalls;
+    vector<float> lastMicros;
+    vector<unsigned char> lastSolved;
+
+    vector<vector<long> > byClues;      // Ids per clue count
+    vector<vector<long> > byGrade;      // Ids per grade
+    vector<long> byHash;                // Ids sorted by hash
+
+    bool matches(long id, const storeQuery &query) const;
+};
+
+bool parseQuery(const char *spec, storeQuery &query);
+// reads comma separated conditions such as "clues=17,calls>10000".
+// terms are clues=N, clues<N, clues>N, grade=NAME, calls<N, calls>N
+// and unsolved. returns false on a term it does not understand
+
+unsigned long long canonicalHash(const char *cells);
+// hash that is the same for puzzles equal up to transposition, band and
+// stack swaps and relabeling of the values
+
+#endif  // PUZZLE_STORE
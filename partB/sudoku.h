@@ -0,0 +1,101 @@
+/* Matthew Egg and Charles Daigle
+ * EECE 2560 Project 4 - Part B
+ */
+
+#ifndef SUDOKU_LIBRARY
+#define SUDOKU_LIBRARY
+
+/* Embeddable solver interface, usable from C and C++.
+ *
+ * Puzzles and solutions are caller-owned buffers of SUDOKU_CELLS bytes,
+ * row by row: '1' to '9' for a value and '.' or '0' for a blank. No
+ * function throws, keeps global state or writes to a stream, so any
+ * thread may call any function at any time; SAT solves reuse a solver
+ * owned by the calling thread. Every function reports through its status
+ * code and leaves its outputs untouched when it rejects its arguments or
+ * the puzzle.
+ */
+
+#define SUDOKU_CELLS 81
+
+typedef enum
+{
+    SUDOKU_OK = 0,
+    SUDOKU_BAD_ARGUMENT,        /* A required pointer is null */
+    SUDOKU_BAD_INPUT,           /* A byte is not a value or a blank */
+    SUDOKU_CONFLICT,            /* The givens repeat a value in a unit */
+    SUDOKU_NO_SOLUTION,
+    SUDOKU_INVALID_SOLUTION,    /* sudoku_validate found a problem */
+    SUDOKU_INTERNAL_ERROR       /* Out of memory or a broken invariant */
+} sudoku_status;
+
+typedef enum { SUDOKU_ENGINE_BACKTRACK, SUDOKU_ENGINE_SAT, SUDOKU_ENGINE_BAND } sudoku_engine;
+
+typedef enum
+{
+    SUDOKU_GRADE_NAKED_SINGLES,     /* Solved by naked singles alone */
+    SUDOKU_GRADE_HIDDEN_SINGLES,    /* Needs hidden singles too */
+    SUDOKU_GRADE_SEARCH             /* Needs guessing */
+} sudoku_grade_level;
+
+typedef enum
+{
+    SUDOKU_CHECK_VALID,
+    SUDOKU_CHECK_BAD_CHARACTER,
+    SUDOKU_CHECK_CLUES_CHANGED,
+    SUDOKU_CHECK_ROW_REPEAT,
+    SUDOKU_CHECK_COLUMN_REPEAT,
+    SUDOKU_CHECK_SQUARE_REPEAT
+} sudoku_check;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Solves a puzzle into solution. calls, if not null, receives the
+ * recursive calls (backtracking) or decisions + 1 (SAT) spent. */
+sudoku_status sudoku_solve(const char *puzzle, char *solution, sudoku_engine engine, long *calls);
+
+/* Counts solutions, stopping at limit (0 for no limit). */
+sudoku_status sudoku_count(const char *puzzle, long limit, long *count);
+
+/* Checks a solution against its puzzle. Returns SUDOKU_OK for a valid
+ * solution and SUDOKU_INVALID_SOLUTION otherwise; check, if not null,
+ * receives the first problem found. */
+sudoku_status sudoku_validate(const char *puzzle, const char *solution, sudoku_check *check);
+
+/* Grades a puzzle by the simplest rules that solve it. */
+sudoku_status sudoku_grade(const char *puzzle, sudoku_grade_level *grade);
+
+/* Short description of a status, never null. */
+const char *sudoku_status_name(sudoku_status status);
+
+#ifdef __cplusplus
+}
+
+namespace sudoku
+{
+    inline sudoku_status solve(const char *puzzle, char *solution, sudoku_engine engine = SUDOKU_ENGINE_SAT,
+                               long *calls = 0)
+    {
+        return sudoku_solve(puzzle, solution, engine, calls);
+    }
+
+    inline sudoku_status count(const char *puzzle, long limit, long &result)
+    {
+        return sudoku_count(puzzle, limit, &result);
+    }
+
+    inline sudoku_status validate(const char *puzzle, const char *solution, sudoku_check *check = 0)
+    {
+        return sudoku_validate(puzzle, solution, check);
+    }
+
+    inline sudoku_status grade(const char *puzzle, sudoku_grade_level &result)
+    {
+        return sudoku_grade(puzzle, &result);
+    }
+}
+#endif
+
+#endif  /* SUDOKU_LIBRARY */
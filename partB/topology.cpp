@@ -0,0 +1,240 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include <algorithm>
+#include <cstdio>
+#include <dirent.h>
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include "topology.h"
+using namespace std;
+
+const char *const CpuDir = "/sys/devices/system/cpu";
+const char *const NodeDir = "/sys/devices/system/node";
+
+/** @brief Reads the first word of a sysfs file
+ * @param path The file
+ * @param value Set to the word
+ * @return True if the file was read, false otherwise
+*/
+bool readWord(const string &path, string &value)
+{
+    ifstream fin(path.c_str());
+    return (bool)(fin >> value);
+}
+
+/** @brief Reads a number from a sysfs file
+ * @param path The file
+ * @param fallback The value if the file cannot be read
+ * @return The number
+*/
+int readNumber(const string &path, int fallback)
+{
+    ifstream fin(path.c_str());
+    int value;
+    return fin >> value ? value : fallback;
+}
+
+/** @brief Parses a processor list like 0-3,8,10-11
+ * @param list The list
+ * @return The processors
+*/
+vector<int> parseCpuList(const string &list)
+{
+    vector<int> cpus;
+    stringstream in(list);
+    string range;
+    while (getline(in, range, ','))
+    {
+        int low, high;
+        char dash;
+        stringstream part(range);
+        if (!(part >> low))
+            continue;
+        high = part >> dash >> high ? high : low;
+        for (int cpu = low; cpu <= high; cpu++)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+/** @brief Constructor for cpuTopology class
+ * @param None
+ * @return None
+*/
+cpuTopology::cpuTopology() : cores(0), sockets(0), first(0)
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        CPU_SET(0, &allowed);
+
+    vector<int> nodeOf(CPU_SETSIZE, 0);
+    if (DIR *dir = opendir(NodeDir))
+    {
+        while (dirent *entry = readdir(dir))
+        {
+            int node;
+            string list;
+            if (sscanf(entry->d_name, "node%d", &node) != 1
+                || !readWord(string(NodeDir) + "/" + entry->d_name + "/cpulist", list))
+                continue;
+            vector<int> cpus = parseCpuList(list);
+            for (size_t k = 0; k < cpus.size(); k++)
+                if (cpus[k] < CPU_SETSIZE)
+                    nodeOf[cpus[k]] = node;
+        }
+        closedir(dir);
+    }
+
+    vector<cpuPlace> all;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        if (CPU_ISSET(cpu, &allowed))
+        {
+            string base = string(CpuDir) + "/cpu" + to_string(cpu) + "/topology/";
+            cpuPlace place = { cpu, readNumber(base + "core_id", cpu), readNumber(base + "physical_package_id", 0),
+                               nodeOf[cpu], false };
+            all.push_back(place);
+        }
+
+    sort(all.begin(), all.end(), [](const cpuPlace &x, const cpuPlace &y) {
+        return x.socket != y.socket ? x.socket < y.socket : x.core != y.core ? x.core < y.core : x.cpu < y.cpu;
+    });
+    for (size_t k = 1; k < all.size(); k++)
+        all[k].sibling = all[k].socket == all[k - 1].socket && all[k].core == all[k - 1].core;
+    stable_partition(all.begin(), all.end(), [](const cpuPlace &p) { return !p.sibling; });  // Whole cores first
+    order = all;
+
+    for (size_t k = 0; k < order.size(); k++)
+    {
+        if (!order[k].sibling)
+        {
+            cores++;
+            if (k == 0 || order[k].socket != order[k - 1].socket)
+                sockets++;
+        }
+        if (find(nodes.begin(), nodes.end(), order[k].node) == nodes.end())
+            nodes.push_back(order[k].node);
+    }
+    sort(nodes.begin(), nodes.end());
+
+    string base = string(CpuDir) + "/cpu" + to_string(order[0].cpu) + "/cache/index";
+    for (int index = 0;; index++)
+    {
+        string dir = base + to_string(index) + "/";
+        cacheLevel cache;
+        cache.level = readNumber(dir + "level", -1);
+        if (cache.level < 0)
+            break;
+        readWord(dir + "type", cache.type);
+        readWord(dir + "size", cache.size);
+        readWord(dir + "shared_cpu_list", cache.shared);
+        cache.line = readNumber(dir + "coherency_line_size", 0);
+        caches.push_back(cache);
+    }
+}
+
+/** @brief Gets the number of processors
+ * @param None
+ * @return The number of processors this process may run on
+*/
+int cpuTopology::cpuCount() const
+{
+    return (int)order.size();
+}
+
+/** @brief Gets the number of physical cores
+ * @param None
+ * @return The number of cores with a processor this process may run on
+*/
+int cpuTopology::coreCount() const
+{
+    return cores;
+}
+
+/** @brief Gets the number of sockets
+ * @param None
+ * @return The number of sockets with a processor this process may run on
+*/
+int cpuTopology::socketCount() const
+{
+    return sockets;
+}
+
+/** @brief Gets the number of memory nodes
+ * @param None
+ * @return The number of nodes with a processor this process may run on
+*/
+int cpuTopology::nodeCount() const
+{
+    return (int)nodes.size();
+}
+
+/** @brief Counts the cores of the first sockets
+ * @param sockets The number of sockets, in pinning order
+ * @return The number of physical cores in them
+*/
+int cpuTopology::coresIn(int sockets) const
+{
+    int count = 0, seen = 0;
+    for (size_t k = 0; k < order.size() && !order[k].sibling; k++)
+    {
+        if (k == 0 || order[k].socket != order[k - 1].socket)
+            seen++;
+        if (seen > sockets)
+            break;
+        count++;
+    }
+    return count;
+}
+
+/** @brief Gets the processor of a worker
+ * @param k The worker
+ * @return The processor
+*/
+const cpuPlace &cpuTopology::slot(int k) const
+{
+    return order[(first + k) % order.size()];
+}
+
+/** @brief Moves the start of the pinning order
+ * @param slots The number of slots to move on
+ * @return None
+*/
+void cpuTopology::skip(int slots)
+{
+    first = (first + slots) % (int)order.size();
+}
+
+/** @brief Prints the topology
+ * @param out The stream to print to
+ * @return None
+*/
+void cpuTopology::report(ostream &out) const
+{
+    out << "topology cpus=" << cpuCount() << " cores=" << cores << " sockets=" << sockets << " nodes=" << nodeCount()
+        << endl;
+    for (size_t k = 0; k < caches.size(); k++)
+        out << "cache level=" << caches[k].level << " type=" << caches[k].type << " size=" << caches[k].size
+            << " line=" << caches[k].line << " shared=" << caches[k].shared << endl;
+    for (int k = 0; k < cpuCount(); k++)
+    {
+        const cpuPlace &place = slot(k);
+        out << "slot " << k << " cpu=" << place.cpu << " socket=" << place.socket << " core=" << place.core
+            << " node=" << place.node << (place.sibling ? " sibling" : "") << endl;
+    }
+}
+
+/** @brief Pins the calling thread to a processor
+ * @param cpu The processor
+ * @return True if the thread is pinned, false otherwise
+*/
+bool pinThread(int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
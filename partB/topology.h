@@ -0,0 +1,81 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef CPU_TOPOLOGY
+#define CPU_TOPOLOGY
+
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// The processors this process may run on, read from
+// /sys/devices/system/cpu and /sys/devices/system/node, and the order
+// worker threads are pinned in. Workers fill the cores of one socket
+// before the next, one hardware thread per core, and only then take the
+// second threads of the cores, so a pool of up to one socket's cores
+// shares one last-level cache and one memory node.
+//
+// Memory is placed on a node by the kernel's first-touch policy: a page
+// lives on the node of the thread that first writes it. A pinned thread
+// that builds its own state therefore gets node-local memory without
+// any NUMA library.
+
+// One logical processor
+struct cpuPlace
+{
+    int cpu;        // Number the kernel uses
+    int core;       // Physical core, counted within its socket
+    int socket;     // Physical package
+    int node;       // NUMA memory node
+    bool sibling;   // True if another processor of the core comes first
+};
+
+// One cache seen by the first processor
+struct cacheLevel
+{
+    int level;
+    string type;    // Data, Instruction or Unified
+    string size;    // As the kernel prints it, like 32K
+    string shared;  // Processors sharing it, as a list like 0-3,8-11
+    int line;       // Bytes in a line
+};
+
+class cpuTopology
+{
+public:
+    cpuTopology();
+    // reads the topology. where sysfs is missing, each allowed processor
+    // is its own core on socket 0 and node 0
+
+    int cpuCount() const;
+    int coreCount() const;
+    int socketCount() const;
+    int nodeCount() const;
+    int coresIn(int sockets) const;
+    // physical cores in the first sockets sockets of the order
+
+    const cpuPlace &slot(int k) const;
+    // the processor worker k is pinned to; the order wraps around
+
+    void skip(int slots);
+    // starts the order slots further on, so separate pools in separate
+    // processes take separate processors
+
+    void report(ostream &out) const;
+    // prints the counts, the caches and the pinning order as key=value lines
+
+private:
+    vector<cpuPlace> order;     // Processors in pinning order
+    vector<int> nodes;          // Nodes in use, ascending
+    vector<cacheLevel> caches;
+    int cores;
+    int sockets;
+    int first;  // Slot worker 0 takes
+};
+
+bool pinThread(int cpu);
+// restricts the calling thread to one processor. returns false if the
+// kernel refuses
+
+#endif  // CPU_TOPOLOGY
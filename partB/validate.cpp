@@ -0,0 +1,143 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include "validate.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+/** @brief Gets the name of a validation result
+ * @param result The result
+ * @return A short name for reports
+*/
+const char *validationName(validationResult result)
+{
+    switch (result)
+    {
+    case ValidSolution:
+        return "valid";
+    case BadCharacter:
+        return "bad-character";
+    case CluesChanged:
+        return "clues-changed";
+    case RowRepeat:
+        return "row-repeat";
+    case ColumnRepeat:
+        return "column-repeat";
+    default:
+        return "square-repeat";
+    }
+}
+
+/** @brief Checks that every cell holds a value and every clue is kept
+ * @param puzzle The puzzle
+ * @param solution The submitted solution
+ * @return BadCharacter, CluesChanged or ValidSolution
+*/
+inline validationResult checkCells(const char *puzzle, const char *solution)
+{
+    int k = 0;
+    unsigned badChar = 0, changed = 0;
+#ifdef __SSE2__
+    const __m128i one = _mm_set1_epi8('0' + MinValue);
+    const __m128i top = _mm_set1_epi8(MaxValue - MinValue);
+    const __m128i blank = _mm_set1_epi8('.');
+    for (; k + 16 <= CellCount; k += 16)    // 16 cells per step
+    {
+        __m128i p = _mm_loadu_si128((const __m128i *)(puzzle + k));
+        __m128i s = _mm_loadu_si128((const __m128i *)(solution + k));
+        __m128i v = _mm_sub_epi8(s, one);
+        badChar |= _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, top), top)) ^ 0xFFFF;  // v > 8 unsigned
+        __m128i kept = _mm_or_si128(_mm_cmpeq_epi8(p, blank), _mm_cmpeq_epi8(p, s));
+        changed |= _mm_movemask_epi8(kept) ^ 0xFFFF;
+    }
+#endif
+    for (; k < CellCount; k++)
+    {
+        badChar |= (unsigned)(unsigned char)(solution[k] - '0' - MinValue) > (unsigned)(MaxValue - MinValue);
+        changed |= puzzle[k] != '.' && puzzle[k] != solution[k];
+    }
+
+    if (badChar)
+        return BadCharacter;
+    return changed ? CluesChanged : ValidSolution;
+}
+
+// Value bit of each character, 0 for anything that is not a value
+struct valueBits
+{
+    unsigned short bits[256];
+
+    valueBits()
+    {
+        for (int ch = 0; ch < 256; ch++)
+            bits[ch] = (ch >= '0' + MinValue && ch <= '0' + MaxValue) ? 1 << (ch - '0' - MinValue) : 0;
+    }
+};
+
+const valueBits valueBit;
+
+/** @brief Validates one solution
+ * @param puzzle The puzzle
+ * @param solution The submitted solution
+ * @return The first problem found, or ValidSolution
+*/
+validationResult validateSolution(const char *puzzle, const char *solution)
+{
+    // Each unit must set all nine value bits. Nine cells can only do that
+    // if their values are all different, so this is a permutation check.
+    // A character that is not a value sets no bit and fails it as well
+    unsigned rowsOk = AllValues, cols[BoardSize] = { 0 }, boxes[BoardSize] = { 0 };
+#pragma GCC unroll 9
+    for (int r = 0; r < BoardSize; r++)
+    {
+        unsigned row = 0;
+        const unsigned char *line = (const unsigned char *)solution + r * BoardSize;
+        unsigned *boxRow = boxes + SquareSize * (r / SquareSize);
+#pragma GCC unroll 9
+        for (int c = 0; c < BoardSize; c++)
+        {
+            unsigned bit = valueBit.bits[line[c]];
+            row |= bit;
+            cols[c] |= bit;
+            boxRow[c / SquareSize] |= bit;
+        }
+        rowsOk &= row;
+    }
+
+    unsigned colsOk = AllValues, boxesOk = AllValues;
+    for (int n = 0; n < BoardSize; n++)
+    {
+        colsOk &= cols[n];
+        boxesOk &= boxes[n];
+    }
+
+    validationResult cells = checkCells(puzzle, solution);
+    if (cells != ValidSolution)
+        return cells;   // Bad characters are reported as such, not as repeats
+    if (rowsOk != AllValues)
+        return RowRepeat;
+    if (colsOk != AllValues)
+        return ColumnRepeat;
+    return boxesOk == AllValues ? ValidSolution : SquareRepeat;
+}
+
+/** @brief Validates a batch of solutions
+ * @param puzzles The puzzles, back to back
+ * @param solutions The submitted solutions, back to back
+ * @param count The number of records
+ * @param results One validationResult per record
+ * @return The number of valid solutions
+*/
+long validateBatch(const char *puzzles, const char *solutions, long count, unsigned char *results)
+{
+    long valid = 0;
+    for (long n = 0; n < count; n++)
+    {
+        validationResult result = validateSolution(puzzles + n * CellCount, solutions + n * CellCount);
+        results[n] = (unsigned char)result;
+        valid += result == ValidSolution;
+    }
+    return valid;
+}
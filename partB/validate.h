@@ -0,0 +1,24 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef SOLUTION_VALIDATOR
+#define SOLUTION_VALIDATOR
+
+#include "board.h"
+
+// Checks submitted solutions against their puzzles without building a
+// board. Puzzles and solutions are BoardSize * BoardSize characters row
+// by row; batches are records stored back to back.
+
+enum validationResult { ValidSolution, BadCharacter, CluesChanged, RowRepeat, ColumnRepeat, SquareRepeat };
+
+const char *validationName(validationResult result);
+
+validationResult validateSolution(const char *puzzle, const char *solution);
+// the first problem found, or ValidSolution
+
+long validateBatch(const char *puzzles, const char *solutions, long count, unsigned char *results);
+// validates count records, storing each validationResult in results.
+// returns the number of valid solutions
+
+#endif  // SOLUTION_VALIDATOR
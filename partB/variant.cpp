@@ -0,0 +1,32 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#include "variant.h"
+using namespace std;
+
+const char *const variantNames[] = { "classic", "diagonal", "windoku", "antiknight", "jigsaw" };
+
+/** @brief Gets the name of a variant
+ * @param variant The variant
+ * @return The name used on the command line
+*/
+const char *variantName(variantType variant)
+{
+    return variantNames[variant];
+}
+
+/** @brief Looks up a variant by name
+ * @param name The name used on the command line
+ * @param variant Set to the variant if the name is known
+ * @return True if the name is known, false otherwise
+*/
+bool parseVariant(const char *name, variantType &variant)
+{
+    for (int v = ClassicVariant; v <= JigsawVariant; v++)
+        if (strcmp(name, variantNames[v]) == 0)
+        {
+            variant = (variantType)v;
+            return true;
+        }
+    return false;
+}
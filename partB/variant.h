@@ -0,0 +1,389 @@
+// Matthew Egg and Charles Daigle
+// EECE 2560 Project 4 - Part B
+
+#ifndef VARIANT_BOARD
+#define VARIANT_BOARD
+
+#include <iostream>
+#include <cstring>
+#include "board.h"
+using namespace std;
+
+// Sudoku variants as constraint sets. A rule set lists the units it adds
+// to the rows and columns and says whether it uses the 3 x 3 squares, an
+// irregular region per cell (jigsaw) or the anti-knight rule. The tables a
+// variantBoard needs are built from it by constexpr code, so every variant
+// is checked with plain mask operations and no run-time dispatch.
+
+enum variantType { ClassicVariant, DiagonalVariant, WindokuVariant, AntiKnightVariant, JigsawVariant };
+
+const char *variantName(variantType variant);
+bool parseVariant(const char *name, variantType &variant);
+
+const int MaxCellUnits = 6;     // Units one cell can belong to in any variant
+const int KnightMoves = 8;
+
+// Rows, columns and squares
+struct classicRules
+{
+    static constexpr int ExtraUnits = 0;
+    static constexpr bool Jigsaw = false;
+    static constexpr bool AntiKnight = false;
+    static constexpr int extraCell(int, int) { return 0; }
+};
+
+// Both long diagonals hold every value once
+struct diagonalRules : classicRules
+{
+    static constexpr int ExtraUnits = 2;
+    static constexpr int extraCell(int unit, int k)
+    {
+        return unit == 0 ? k * BoardSize + k : k * BoardSize + BoardSize - 1 - k;
+    }
+};
+
+// Four more 3 x 3 windows, one square in from each corner
+struct windokuRules : classicRules
+{
+    static constexpr int ExtraUnits = 4;
+    static constexpr int extraCell(int unit, int k)
+    {
+        return (1 + 4 * (unit / 2) + k / SquareSize) * BoardSize + 1 + 4 * (unit % 2) + k % SquareSize;
+    }
+};
+
+// Cells a knight's move apart hold different values
+struct antiKnightRules : classicRules
+{
+    static constexpr bool AntiKnight = true;
+};
+
+// Irregular regions, given with each board, replace the squares
+struct jigsawRules : classicRules
+{
+    static constexpr bool Jigsaw = true;
+};
+
+// Cell lists and peer lists of a rule set
+template <typename Rules>
+struct variantTables
+{
+    static constexpr int FixedUnits = (Rules::Jigsaw ? 2 : 3) * BoardSize + Rules::ExtraUnits;
+
+    int unitCells[FixedUnits][BoardSize];
+    int cellUnits[CellCount][MaxCellUnits]; // Fixed units containing each cell
+    int cellUnitCount[CellCount];
+    int knights[CellCount][KnightMoves];    // Cells a knight's move away
+    int knightCount[CellCount];
+};
+
+/** @brief Builds the tables of a rule set
+ * @param None
+ * @return The tables
+ * @note Evaluated by the compiler
+*/
+template <typename Rules>
+constexpr variantTables<Rules> makeVariantTables()
+{
+    variantTables<Rules> t{};
+    int u = 0;
+    for (int n = 0; n < BoardSize; n++, u++)
+        for (int k = 0; k < BoardSize; k++)
+            t.unitCells[u][k] = n * BoardSize + k;  // Row n
+    for (int n = 0; n < BoardSize; n++, u++)
+        for (int k = 0; k < BoardSize; k++)
+            t.unitCells[u][k] = k * BoardSize + n;  // Column n
+    if (!Rules::Jigsaw)
+        for (int n = 0; n < BoardSize; n++, u++)
+            for (int k = 0; k < BoardSize; k++)
+                t.unitCells[u][k] = (SquareSize * (n / SquareSize) + k / SquareSize) * BoardSize
+                                    + SquareSize * (n % SquareSize) + k % SquareSize;   // Square n
+    for (int e = 0; e < Rules::ExtraUnits; e++, u++)
+        for (int k = 0; k < BoardSize; k++)
+            t.unitCells[u][k] = Rules::extraCell(e, k);
+
+    for (u = 0; u < variantTables<Rules>::FixedUnits; u++)
+        for (int k = 0; k < BoardSize; k++)
+        {
+            int cell = t.unitCells[u][k];
+            t.cellUnits[cell][t.cellUnitCount[cell]++] = u;
+        }
+
+    const int moves[KnightMoves][2] = {{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1}};
+    if (Rules::AntiKnight)
+        for (int cell = 0; cell < CellCount; cell++)
+            for (int m = 0; m < KnightMoves; m++)
+            {
+                int r = cell / BoardSize + moves[m][0], c = cell % BoardSize + moves[m][1];
+                if (r >= 0 && r < BoardSize && c >= 0 && c < BoardSize)
+                    t.knights[cell][t.knightCount[cell]++] = r * BoardSize + c;
+            }
+    return t;
+}
+
+// A board under a rule set, solved by backtracking on the cell with the
+// fewest candidates
+template <typename Rules>
+class variantBoard
+{
+public:
+    variantBoard();
+
+    bool setRegions(const char *layout);
+    // jigsaw only: reads the region of every cell, '1' to '9' row by row.
+    // returns false unless there are BoardSize regions of BoardSize cells
+
+    bool initialize(const char *cells);
+    // loads a puzzle, '.' for a blank. returns false if the givens clash
+
+    unsigned short candidates(int cell) const;
+    // values that no unit or peer of a blank cell already holds
+
+    bool solve();
+    // fills the board. returns false if it has no solution
+
+    bool isSolved() const;
+    int getCallCount() const;
+    void resetCallCount();
+    void getCells(char *cells) const;
+    void print(ostream &out = cout) const;
+
+    static constexpr variantTables<Rules> tables = makeVariantTables<Rules>();
+
+private:
+    signed char cells[CellCount];
+    int filled;
+    unsigned short unitMask[variantTables<Rules>::FixedUnits];
+    signed char region[CellCount];      // Jigsaw region of each cell
+    unsigned short regionMask[BoardSize];
+    int callCount;
+
+    void place(int cell, int val);
+    void remove(int cell);
+    bool search();
+};
+
+template <typename Rules>
+constexpr variantTables<Rules> variantBoard<Rules>::tables;
+
+/** @brief Constructor for variantBoard class
+ * @param None
+ * @return None
+*/
+template <typename Rules>
+variantBoard<Rules>::variantBoard() : filled(0), callCount(0)
+{
+    memset(cells, Blank, sizeof(cells));
+    memset(unitMask, 0, sizeof(unitMask));
+    memset(regionMask, 0, sizeof(regionMask));
+    for (int cell = 0; cell < CellCount; cell++)
+        region[cell] = (signed char)boxOf(cell);   // Squares until regions are given
+}
+
+/** @brief Reads the jigsaw regions
+ * @param layout The region of each cell, '1' to '9' row by row
+ * @return True if the layout is valid, false otherwise
+*/
+template <typename Rules>
+bool variantBoard<Rules>::setRegions(const char *layout)
+{
+    int sizes[BoardSize] = {0};
+    for (int cell = 0; cell < CellCount; cell++)
+    {
+        int r = layout[cell] - '1';
+        if (r < 0 || r >= BoardSize || ++sizes[r] > BoardSize)
+            return false;
+    }
+    for (int cell = 0; cell < CellCount; cell++)
+        region[cell] = (signed char)(layout[cell] - '1');
+    return true;
+}
+
+/** @brief Writes a value into a blank cell
+ * @param cell The cell number
+ * @param val The value
+ * @return None
+*/
+template <typename Rules>
+void variantBoard<Rules>::place(int cell, int val)
+{
+    unsigned short bit = 1 << (val - MinValue);
+    cells[cell] = (signed char)val;
+    filled++;
+    for (int k = 0; k < tables.cellUnitCount[cell]; k++)
+        unitMask[tables.cellUnits[cell][k]] |= bit;
+    if (Rules::Jigsaw)
+        regionMask[region[cell]] |= bit;
+}
+
+/** @brief Blanks a cell filled by place
+ * @param cell The cell number
+ * @return None
+*/
+template <typename Rules>
+void variantBoard<Rules>::remove(int cell)
+{
+    unsigned short bit = 1 << (cells[cell] - MinValue);
+    cells[cell] = Blank;
+    filled--;
+    for (int k = 0; k < tables.cellUnitCount[cell]; k++)
+        unitMask[tables.cellUnits[cell][k]] &= ~bit;
+    if (Rules::Jigsaw)
+        regionMask[region[cell]] &= ~bit;
+}
+
+/** @brief Gets the values that fit in a cell
+ * @param cell The cell number
+ * @return A mask of the values no unit or peer holds
+*/
+template <typename Rules>
+unsigned short variantBoard<Rules>::candidates(int cell) const
+{
+    unsigned short used = 0;
+    for (int k = 0; k < tables.cellUnitCount[cell]; k++)
+        used |= unitMask[tables.cellUnits[cell][k]];
+    if (Rules::Jigsaw)
+        used |= regionMask[region[cell]];
+    if (Rules::AntiKnight)
+        for (int k = 0; k < tables.knightCount[cell]; k++)
+        {
+            int peer = tables.knights[cell][k];
+            if (cells[peer] != Blank)
+                used |= 1 << (cells[peer] - MinValue);
+        }
+    return AllValues & ~used;
+}
+
+/** @brief Loads a puzzle
+ * @param puzzle The BoardSize * BoardSize characters of the board, '.' for a blank
+ * @return True if the givens are consistent, false otherwise
+*/
+template <typename Rules>
+bool variantBoard<Rules>::initialize(const char *puzzle)
+{
+    memset(cells, Blank, sizeof(cells));
+    memset(unitMask, 0, sizeof(unitMask));
+    memset(regionMask, 0, sizeof(regionMask));
+    filled = 0;
+    for (int cell = 0; cell < CellCount; cell++)
+    {
+        if (puzzle[cell] == '.')
+            continue;
+        int val = puzzle[cell] - '0';
+        if (val < MinValue || val > MaxValue)
+            throw rangeError("bad value in variantBoard::initialize");
+        if (!(candidates(cell) & (1 << (val - MinValue))))
+            return false;   // Clashes with an earlier given
+        place(cell, val);
+    }
+    return true;
+}
+
+/** @brief Fills the blank cells by backtracking
+ * @param None
+ * @return True if a solution was found, false otherwise
+*/
+template <typename Rules>
+bool variantBoard<Rules>::search()
+{
+    callCount++;
+    if (filled == CellCount)
+        return true;
+
+    int best = -1, fewest = MaxValue + 1;
+    unsigned short bestCand = 0;
+    for (int cell = 0; cell < CellCount && fewest > 1; cell++)
+    {
+        if (cells[cell] != Blank)
+            continue;
+        unsigned short cand = candidates(cell);
+        int count = 0;
+        for (unsigned short rest = cand; rest; rest &= rest - 1)
+            count++;
+        if (count < fewest)
+        {
+            fewest = count;
+            best = cell;
+            bestCand = cand;
+        }
+    }
+
+    for (int v = 0; v < MaxValue; v++)
+        if (bestCand & (1 << v))
+        {
+            place(best, v + MinValue);
+            if (search())
+                return true;
+            remove(best);
+        }
+    return false;
+}
+
+/** @brief Solves the board
+ * @param None
+ * @return True if the board is solved, false otherwise
+*/
+template <typename Rules>
+bool variantBoard<Rules>::solve()
+{
+    return search();
+}
+
+/** @brief Checks if every cell is filled
+ * @param None
+ * @return True if the board is solved, false otherwise
+*/
+template <typename Rules>
+bool variantBoard<Rules>::isSolved() const
+{
+    return filled == CellCount;
+}
+
+/** @brief Gets the number of recursive calls
+ * @param None
+ * @return The number of calls since the last reset
+*/
+template <typename Rules>
+int variantBoard<Rules>::getCallCount() const
+{
+    return callCount;
+}
+
+/** @brief Resets the recursive call counter
+ * @param None
+ * @return None
+*/
+template <typename Rules>
+void variantBoard<Rules>::resetCallCount()
+{
+    callCount = 0;
+}
+
+/** @brief Copies out the board
+ * @param out Set to BoardSize * BoardSize characters, '.' for a blank
+ * @return None
+*/
+template <typename Rules>
+void variantBoard<Rules>::getCells(char *out) const
+{
+    for (int cell = 0; cell < CellCount; cell++)
+        out[cell] = cells[cell] == Blank ? '.' : (char)('0' + cells[cell]);
+}
+
+/** @brief Prints the board as one row of characters per line
+ * @param out The stream to print to
+ * @return None
+*/
+template <typename Rules>
+void variantBoard<Rules>::print(ostream &out) const
+{
+    char text[CellCount];
+    getCells(text);
+    for (int i = 0; i < BoardSize; i++)
+    {
+        out.write(text + i * BoardSize, BoardSize);
+        out << endl;
+    }
+}
+
+#endif  // VARIANT_BOARD